@@ -0,0 +1,41 @@
+#ifndef JOB_SHOP_ALGORITHMS
+#define JOB_SHOP_ALGORITHMS
+
+#include <string_view>
+#include "dataset.hpp"
+#include "dispatch.hpp"
+#include "random.hpp"
+#include "schedule.hpp"
+
+namespace js {
+
+    struct named_algorithm {
+        std::string_view name;
+        void (* run)(const dataset&, schedule&);
+        void (* randomized)(const dataset&, schedule&, splitmix64&, size_t);
+        // For flexible instances: picks a machine for every operation of the dataset the schedule is over.
+        void (* route)(dataset&, schedule&);
+    };
+
+    template<typename rule>
+    constexpr named_algorithm rule_algorithm(std::string_view name) {
+        return {name, dispatch_greedy<rule>, dispatch_randomized<rule>, dispatch_flexible<rule>};
+    }
+
+    inline constexpr named_algorithm algorithms[] = {
+            rule_algorithm<alex_rule>("alex"),
+            rule_algorithm<stachu_rule>("stachu"),
+            rule_algorithm<spt_rule>("spt"),
+            rule_algorithm<lpt_rule>("lpt"),
+            rule_algorithm<mwkr_rule>("mwkr"),
+            rule_algorithm<mopnr_rule>("mopnr"),
+            rule_algorithm<fifo_rule>("fifo"),
+    };
+
+    inline const named_algorithm* find_algorithm(std::string_view name) {
+        for (const named_algorithm& algorithm : algorithms) if (algorithm.name == name) return &algorithm;
+        return nullptr;
+    }
+}
+
+#endif //JOB_SHOP_ALGORITHMS
@@ -0,0 +1,155 @@
+#ifndef JOB_SHOP_BATCH
+#define JOB_SHOP_BATCH
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "algorithms.hpp"
+#include "dataset.hpp"
+#include "instrument.hpp"
+#include "lower_bound.hpp"
+#include "schedule.hpp"
+#include "solution_cache.hpp"
+#include "tabu_search.hpp"
+#include "thread_pool.hpp"
+
+namespace js {
+
+    enum class batch_format { csv, json };
+
+    struct batch_options {
+        std::vector<const named_algorithm*> algorithms;
+        size_t threads = std::thread::hardware_concurrency();
+        // Binds the workers to cores; every run already loads its instance on the worker that solves it.
+        bool pin = false;
+        batch_format format = batch_format::csv;
+        std::optional<tabu_options> improve;
+        // Directory of the solution cache; empty disables it.
+        std::string cache;
+    };
+
+    // Every regular file of a directory, or every non-empty, non-comment line of a list file.
+    inline std::vector<std::string> batch_instances(const std::filesystem::path& source) {
+        std::vector<std::string> result;
+        if (std::filesystem::is_directory(source)) {
+            for (const auto& entry : std::filesystem::directory_iterator(source))
+                if (entry.is_regular_file()) result.push_back(entry.path().string());
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+        std::ifstream list(source);
+        if (not list.is_open()) throw std::runtime_error("Could not open file " + source.string());
+        for (std::string line; std::getline(list, line);) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (not line.empty() and line[0] != '#') result.push_back(line);
+        }
+        return result;
+    }
+
+    // Every tabu parameter that changes the result, for cache keys.
+    inline std::string tabu_key(const tabu_options& options) {
+        return 'i' + std::to_string(options.iterations) + "-t" + std::to_string(options.tenure) + "-l" +
+               std::to_string(options.time_limit.count());
+    }
+
+    inline std::string batch_header(batch_format format) {
+        return format == batch_format::csv ? "instance,algorithm,makespan,wall_ms,lower_bound,gap" : "";
+    }
+
+    inline std::string batch_line(batch_format format, const std::string& instance, std::string_view algorithm,
+                                  size_t makespan, double wall_ms, size_t lower_bound) {
+        std::string escaped;
+        for (char c : instance) {
+            if (format == batch_format::csv and c == '"') escaped += '"';
+            if (format == batch_format::json and (c == '"' or c == '\\')) escaped += '\\';
+            escaped += c;
+        }
+        char wall[32], gap[32];
+        snprintf(wall, sizeof wall, "%.3f", wall_ms);
+        snprintf(gap, sizeof gap, "%.4f", optimality_gap(makespan, lower_bound));
+        if (format == batch_format::csv)
+            return '"' + escaped + "\"," + std::string(algorithm) + ',' + std::to_string(makespan) + ',' + wall + ',' +
+                   std::to_string(lower_bound) + ',' + gap;
+        return "{\"instance\":\"" + escaped + "\",\"algorithm\":\"" + std::string(algorithm) +
+               "\",\"makespan\":" + std::to_string(makespan) + ",\"wall_ms\":" + wall +
+               ",\"lower_bound\":" + std::to_string(lower_bound) + ",\"gap\":" + gap + '}';
+    }
+
+    // Runs every (instance, algorithm) pair on the pool; each run loads its own dataset and schedule.
+    // Lines are written as runs finish, so their order depends on scheduling. With a cache, constructions and
+    // improvements already solved with the same parameters are read back instead of recomputed, and a tabu search
+    // with new parameters starts from the best improved schedule cached for its algorithm. Instrumented builds also
+    // print every run's counters and phase times on stderr, prefixed with its instance and algorithm; a run stays
+    // on one worker, so they are that worker's counts over the run.
+    inline void run_batch(const std::vector<std::string>& instances, const batch_options& options, std::ostream& out) {
+        std::optional<solution_cache> cache;
+        if (not options.cache.empty()) cache.emplace(options.cache);
+        std::atomic<size_t> reused = 0;
+        std::mutex output_mutex;
+        if (const std::string header = batch_header(options.format); not header.empty()) out << header << '\n';
+        thread_pool pool(options.threads, options.pin);
+        for (const std::string& instance : instances)
+            for (const named_algorithm* algorithm : options.algorithms)
+                pool.submit([&, algorithm] {
+                    std::string line;
+                    std::ostringstream counted;
+                    const instrumentation::block before = instrumentation::thread_snapshot();
+                    try {
+                        std::optional<scoped_phase> timed(phase::parse);
+                        const dataset data = dataset::from_file(instance.c_str());
+                        schedule schedule(data);
+                        timed.emplace(phase::construct);
+                        const auto begin = std::chrono::steady_clock::now();
+                        std::string name(algorithm->name);
+                        bool cached = cache and cache->load(data, name, schedule);
+                        if (not cached) {
+                            algorithm->run(data, schedule);
+                            if (cache) cache->store(data, name, schedule);
+                        }
+                        timed.emplace(phase::improve);
+                        if (options.improve) {
+                            const std::string best = name + "+tabu", key = best + '-' + tabu_key(*options.improve);
+                            cached = cache and cache->load(data, key, schedule);
+                            if (not cached) {
+                                if (cache) cache->load(data, best, schedule);
+                                tabu_search().run(data, schedule, *options.improve);
+                                if (cache) cache->store(data, key, schedule), cache->store(data, best, schedule);
+                            }
+                            name = best;
+                        }
+                        timed.reset();
+                        reused += cached;
+                        const std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - begin;
+                        line = batch_line(options.format, instance, name, schedule.makespan(), wall.count(),
+                                          compute_lower_bounds(data).value());
+                        instrumentation::block run = instrumentation::thread_snapshot();
+                        run -= before;
+                        instrumentation::write(counted, run, instance + ' ' + name + ' ');
+                    } catch (const std::exception& e) {
+                        std::lock_guard lock(output_mutex);
+                        std::cerr << instance << ": " << e.what() << '\n';
+                        return;
+                    }
+                    std::lock_guard lock(output_mutex);
+                    out << line << '\n';
+                    std::cerr << counted.str();
+                });
+        pool.wait();
+        out.flush();
+        if (cache)
+            std::cerr << "cache: " << reused << " of " << instances.size() * options.algorithms.size()
+                      << " runs reused\n";
+    }
+}
+
+#endif //JOB_SHOP_BATCH
@@ -0,0 +1,245 @@
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <benchmark/benchmark.h>
+#include "algorithms.hpp"
+#include "dataset.hpp"
+#include "gap_tree.hpp"
+#include "generator.hpp"
+#include "occupancy.hpp"
+#include "reschedule.hpp"
+#include "schedule.hpp"
+#include "solver.hpp"
+
+// Taillard-style instances seeded by their size, so every run measures the same inputs.
+
+static js::dataset generated(size_t task_count, size_t machine_count) {
+    const auto seed = (int32_t) (task_count * 1000 + machine_count);
+    return js::taillard_instance(task_count, machine_count, seed, seed + 1);
+}
+
+static const std::string& instance_file(size_t task_count, size_t machine_count) {
+    static std::map<std::pair<size_t, size_t>, std::string> files;
+    std::string& path = files[{task_count, machine_count}];
+    if (path.empty()) {
+        path = (std::filesystem::temp_directory_path() /
+                ("job_shop_bench_" + std::to_string(task_count) + "x" + std::to_string(machine_count) + ".txt"))
+                .string();
+        std::ofstream file(path);
+        generated(task_count, machine_count).write(file);
+    }
+    return path;
+}
+
+static const js::dataset& instance(size_t task_count, size_t machine_count) {
+    static std::map<std::pair<size_t, size_t>, js::dataset> instances;
+    const auto [it, inserted] = instances.try_emplace({task_count, machine_count});
+    if (inserted) it->second = generated(task_count, machine_count);
+    return it->second;
+}
+
+static void set_operations(benchmark::State& state, const js::dataset& data) {
+    size_t operations = 0;
+    for (const js::task& t : data.tasks) operations += t.sequence.size();
+    state.SetItemsProcessed((int64_t) (state.iterations() * operations));
+}
+
+static void sizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"jobs", "machines"});
+    for (const auto& [jobs, machines] : {std::pair{10, 10}, {20, 15}, {50, 20}, {100, 20}, {1000, 10}, {1000, 20}})
+        benchmark->Args({jobs, machines});
+    benchmark->Unit(benchmark::kMicrosecond);
+}
+
+static void BM_from_file(benchmark::State& state) {
+    const std::string& path = instance_file(state.range(0), state.range(1));
+    for (auto _ : state) benchmark::DoNotOptimize(js::dataset::from_file(path.c_str()));
+    set_operations(state, instance(state.range(0), state.range(1)));
+}
+BENCHMARK(BM_from_file)->Apply(sizes);
+
+// The embedding path: an instance built from arrays and solved in memory.
+static void BM_solve(benchmark::State& state) {
+    const js::dataset& data = instance(state.range(0), state.range(1));
+    std::vector<uint16_t> machines;
+    std::vector<size_t> durations;
+    for (const js::task& t : data.tasks)
+        for (const js::sub_task& st : t.sequence) machines.push_back(st.machine_id), durations.push_back(st.duration);
+    for (auto _ : state) {
+        const js::dataset copy = js::dataset::from_arrays(data.tasks.size(), data.machine_count, machines, durations);
+        js::schedule schedule(copy);
+        benchmark::DoNotOptimize(js::solve(copy, schedule, {}).makespan);
+    }
+    set_operations(state, data);
+}
+BENCHMARK(BM_solve)->Apply(sizes);
+
+// Placement alone: earliest_start (the public is_available search) and insertion, in a shuffled job-repetition
+// order so operations land in gaps as well as at the end of their machines.
+template<js::placement_index placement>
+static void BM_add_sub_task(benchmark::State& state) {
+    const js::dataset& data = instance(state.range(0), state.range(1));
+    std::vector<int16_t> order;
+    for (const js::task& t : data.tasks) order.insert(order.end(), t.sequence.size(), t.id);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(1));
+    js::schedule schedule(data, placement);
+    std::vector<size_t> next(data.tasks.size());
+    for (auto _ : state) {
+        schedule.reset();
+        std::fill(next.begin(), next.end(), 0);
+        for (int16_t job : order) schedule.add_sub_task(data.tasks[job].sequence[next[job]++]);
+        benchmark::DoNotOptimize(schedule.makespan());
+    }
+    set_operations(state, data);
+}
+BENCHMARK(BM_add_sub_task<js::placement_index::none>)->Apply(sizes);
+BENCHMARK(BM_add_sub_task<js::placement_index::bitset>)->Apply(sizes);
+BENCHMARK(BM_add_sub_task<js::placement_index::gaps>)->Apply(sizes);
+
+// One machine packed with short operations and the free-window query placement makes most, on the interval
+// timeline, on the bitset and on the gap tree. Arguments: operations placed, longest duration.
+template<typename busy_set>
+static void BM_next_fit(benchmark::State& state) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<size_t> duration(1, (size_t) state.range(1));
+    js::timeline reference;
+    busy_set machine;
+    for (int64_t k = 0; k < state.range(0); k++) {
+        const size_t d = duration(rng), start = reference.next_fit(rng() % (size_t) (state.range(0) * 2), d);
+        reference.insert({start, start + d, 0, 0});
+        if constexpr (std::is_same_v<busy_set, js::timeline>) machine.insert({start, start + d, 0, 0});
+        else if constexpr (std::is_same_v<busy_set, js::gap_tree>) machine.occupy(start, start + d);
+        else machine.insert(start, start + d);
+    }
+    std::vector<std::pair<size_t, size_t>> queries(1024);
+    for (auto& [start, d] : queries) start = rng() % (size_t) (state.range(0) * 2), d = duration(rng) * 2;
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& [start, d] = queries[i++ % queries.size()];
+        benchmark::DoNotOptimize(machine.next_fit(start, d));
+    }
+}
+BENCHMARK(BM_next_fit<js::timeline>)->Args({1000, 4})->Args({1000, 50})->Args({10000, 4})->Args({10000, 50});
+BENCHMARK(BM_next_fit<js::occupancy>)->Args({1000, 4})->Args({1000, 50})->Args({10000, 4})->Args({10000, 50});
+BENCHMARK(BM_next_fit<js::gap_tree>)->Args({1000, 4})->Args({1000, 50})->Args({10000, 4})->Args({10000, 50});
+
+static void BM_algorithm(benchmark::State& state, std::string_view name) {
+    const js::dataset& data = instance(state.range(0), state.range(1));
+    const js::named_algorithm& algorithm = *js::find_algorithm(name);
+    for (auto _ : state) {
+        js::schedule schedule(data);
+        algorithm.run(data, schedule);
+        benchmark::DoNotOptimize(schedule.makespan());
+    }
+    set_operations(state, data);
+}
+BENCHMARK_CAPTURE(BM_algorithm, alex, "alex")->Apply(sizes);
+BENCHMARK_CAPTURE(BM_algorithm, stachu, "stachu")->Apply(sizes);
+
+// Cost of the epoch barriers of the deterministic mode: 64 restarts on 20x15, by deterministic and threads.
+static void BM_grasp(benchmark::State& state) {
+    const js::dataset& data = instance(20, 15);
+    js::grasp_options options;
+    options.deterministic = state.range(0) != 0;
+    options.threads = state.range(1);
+    size_t makespan = 0;
+    for (auto _ : state) {
+        js::schedule schedule(data);
+        makespan = js::grasp(data, schedule, *js::find_algorithm("stachu"), options).makespan;
+    }
+    state.counters["makespan"] = (double) makespan;
+}
+BENCHMARK(BM_grasp)->ArgNames({"deterministic", "threads"})->Args({0, 1})->Args({1, 1})->Args({0, 4})->Args({1, 4})
+        ->Unit(benchmark::kMillisecond);
+
+// Scaling curve of GRASP on 1 to all cores, unpinned and pinned with replicated instances, and of the GA.
+static void cores(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"threads", "pinned"});
+    const auto available = (int64_t) std::max(std::thread::hardware_concurrency(), 1u);
+    for (int64_t threads = 1;; threads = std::min(threads * 2, available)) {
+        benchmark->Args({threads, 0})->Args({threads, 1});
+        if (threads == available) break;
+    }
+    benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+static void BM_grasp_scaling(benchmark::State& state) {
+    const js::dataset& data = instance(50, 20);
+    js::grasp_options options;
+    options.restarts = 32;
+    options.threads = state.range(0);
+    options.pin = options.replicate = state.range(1) != 0;
+    for (auto _ : state) {
+        js::schedule schedule(data);
+        benchmark::DoNotOptimize(js::grasp(data, schedule, *js::find_algorithm("stachu"), options).makespan);
+    }
+    state.SetItemsProcessed((int64_t) (state.iterations() * options.restarts));
+}
+BENCHMARK(BM_grasp_scaling)->Apply(cores);
+
+static void BM_genetic_scaling(benchmark::State& state) {
+    const js::dataset& data = instance(50, 20);
+    js::genetic_options options;
+    options.generations = 20;
+    options.threads = state.range(0);
+    options.pin = options.replicate = state.range(1) != 0;
+    for (auto _ : state) {
+        js::schedule schedule(data);
+        benchmark::DoNotOptimize(js::genetic_algorithm().run(data, schedule, options).makespan);
+    }
+}
+BENCHMARK(BM_genetic_scaling)->Apply(cores);
+
+// Cost of exploring the ties with the optimum in the deterministic mode, on a small instance solved to optimality.
+template<bool deterministic>
+static void BM_exact(benchmark::State& state) {
+    const js::dataset data = js::taillard_instance(8, 6, 86, 87);
+    js::branch_and_bound_options options;
+    options.deterministic = deterministic;
+    size_t nodes = 0;
+    for (auto _ : state) {
+        js::schedule schedule(data);
+        nodes = js::branch_and_bound().run(data, schedule, options).nodes;
+    }
+    state.counters["nodes"] = (double) nodes;
+}
+BENCHMARK(BM_exact<false>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_exact<true>)->Unit(benchmark::kMillisecond);
+
+// A breakdown in the middle of a stachu schedule, repaired in place; BM_algorithm/stachu is the full rebuild.
+static void BM_block_machine(benchmark::State& state) {
+    const js::dataset& data = instance(state.range(0), state.range(1));
+    size_t moved = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        js::rescheduler shop(data);
+        js::find_algorithm("stachu")->run(shop.instance(), shop.current());
+        const size_t middle = shop.current().makespan() / 2;
+        shop.advance(middle / 2);
+        state.ResumeTiming();
+        moved += shop.block_machine(0, middle, middle + 100).moved;
+    }
+    state.counters["moved"] = benchmark::Counter((double) moved, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_block_machine)->Apply(sizes)->Iterations(20);
+
+static void BM_print(benchmark::State& state) {
+    const js::dataset& data = instance(state.range(0), state.range(1));
+    js::schedule schedule(data);
+    js::find_algorithm("stachu")->run(data, schedule);
+    std::ostringstream out;
+    for (auto _ : state) {
+        out.str({});
+        out << schedule;
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * out.str().size()));
+}
+BENCHMARK(BM_print)->Apply(sizes);
+
+BENCHMARK_MAIN();
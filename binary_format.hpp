@@ -0,0 +1,74 @@
+#ifndef JOB_SHOP_BINARY_FORMAT
+#define JOB_SHOP_BINARY_FORMAT
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace js {
+
+    static_assert(std::endian::native == std::endian::little, "The binary format is little-endian");
+
+    // Version 1 layout, little-endian: a 24-byte header, then one record per operation job by job. Instances
+    // ("JSPI") hold `binary_operation` records, schedules ("JSPS") one uint32_t start each, `binary_unscheduled`
+    // for operations without one. Records start 8-byte aligned, so a mapped file can be read in place.
+    struct binary_header {
+        char magic[4];
+        uint32_t version;
+        uint32_t task_count, machine_count;
+        uint64_t makespan; // schedules only
+    };
+
+    struct binary_operation {
+        uint16_t machine, reserved;
+        uint32_t duration;
+    };
+
+    static_assert(sizeof(binary_header) == 24 and sizeof(binary_operation) == 8);
+
+    inline constexpr uint32_t binary_version = 1, binary_unscheduled = std::numeric_limits<uint32_t>::max();
+    inline constexpr char binary_instance_magic[4] = {'J', 'S', 'P', 'I'};
+    inline constexpr char binary_schedule_magic[4] = {'J', 'S', 'P', 'S'};
+
+    [[nodiscard]] inline bool has_binary_magic(std::string_view bytes, const char (& magic)[4]) {
+        return bytes.size() >= sizeof magic and std::memcmp(bytes.data(), magic, sizeof magic) == 0;
+    }
+
+    // Header of `bytes` after checking magic, version and that all records are present.
+    [[nodiscard]] inline binary_header read_binary_header(std::string_view bytes, const char (& magic)[4],
+                                                          size_t record_size) {
+        binary_header header{};
+        if (bytes.size() < sizeof header or not has_binary_magic(bytes, magic))
+            throw std::runtime_error("Not a binary " + std::string(magic, sizeof magic) + " file");
+        std::memcpy(&header, bytes.data(), sizeof header);
+        if (header.version != binary_version)
+            throw std::runtime_error("Unsupported binary format version " + std::to_string(header.version));
+        if (bytes.size() < sizeof header + (size_t) header.task_count * header.machine_count * record_size)
+            throw std::runtime_error("Truncated binary file");
+        return header;
+    }
+
+    inline void write_binary_header(std::ostream& out, const char (& magic)[4], size_t task_count,
+                                    size_t machine_count, uint64_t makespan) {
+        binary_header header{};
+        std::memcpy(header.magic, magic, sizeof header.magic);
+        header.version = binary_version;
+        header.task_count = (uint32_t) task_count;
+        header.machine_count = (uint32_t) machine_count;
+        header.makespan = makespan;
+        out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    }
+
+    // Records following the header of a validated buffer, without copying.
+    template<typename record>
+    [[nodiscard]] const record* binary_records(std::string_view bytes) {
+        return reinterpret_cast<const record*>(bytes.data() + sizeof(binary_header));
+    }
+}
+
+#endif //JOB_SHOP_BINARY_FORMAT
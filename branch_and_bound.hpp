@@ -0,0 +1,208 @@
+#ifndef JOB_SHOP_BRANCH_AND_BOUND
+#define JOB_SHOP_BRANCH_AND_BOUND
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "dataset.hpp"
+#include "dispatch.hpp"
+#include "flat_dataset.hpp"
+#include "lower_bound.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+#include "thread_pool.hpp"
+
+namespace js {
+
+    struct branch_and_bound_options {
+        size_t threads = std::thread::hardware_concurrency();
+        bool pin = false;
+        size_t node_limit = 0;
+        std::chrono::milliseconds time_limit{0};
+        // Children of nodes shallower than this are handed to the pool instead of explored in place.
+        size_t split_depth = 3;
+        search_control* control = nullptr;
+        // Also explores nodes whose bound ties the incumbent, and of equal makespans keeps the schedule whose
+        // sequence of branching jobs is lexicographically least, so a search that runs to completion returns the
+        // same schedule at any thread count. Costs the nodes that tie the optimum.
+        bool deterministic = false;
+    };
+
+    struct branch_and_bound_result {
+        size_t makespan = 0, root_bound = 0, nodes = 0;
+        double seconds = 0;
+        bool optimal = false;
+
+        [[nodiscard]] double nodes_per_second() const { return seconds > 0 ? (double) nodes / seconds : 0; }
+    };
+
+    // Exact solver enumerating active schedules: every branch fixes which operation of the Giffler–Thompson
+    // conflict set goes next on its machine, i.e. one more arc of that machine's order in the disjunctive graph.
+    // Nodes are pruned with the one-machine preemptive (Jackson) bound over the unscheduled operations.
+    class branch_and_bound {
+
+        struct node {
+            std::vector<uint16_t> next;
+            std::vector<uint32_t> job_ready, machine_ready, start;
+            uint32_t makespan = 0, bound = 0;
+            size_t depth = 0;
+            // Job branched on at every level; only kept by the deterministic search.
+            std::vector<uint16_t> path;
+        };
+
+        flat_dataset flat;
+        std::vector<uint32_t> tails;
+        std::atomic<uint32_t> upper = 0;
+        std::atomic<size_t> nodes = 0;
+        std::atomic<bool> stopped = false;
+        std::mutex best_mutex;
+        std::vector<uint32_t> best_start;
+        std::vector<uint16_t> best_path;
+        uint32_t best_makespan = 0;
+        bool seeded = true;
+        branch_and_bound_options options;
+        std::chrono::steady_clock::time_point started;
+
+        [[nodiscard]] uint32_t lower_bound(const node& n) const {
+            thread_local std::vector<std::vector<one_machine_operation<uint32_t>>> per_machine;
+            thread_local std::vector<one_machine_operation<uint32_t>> heap;
+            per_machine.resize(flat.machine_count);
+            for (auto& operations : per_machine) operations.clear();
+            uint32_t result = n.makespan;
+            for (size_t job = 0; job < flat.task_count; job++) {
+                uint32_t release = n.job_ready[job];
+                for (size_t op = n.next[job]; op < flat.machine_count; op++) {
+                    const size_t i = flat.index(job, op);
+                    release = std::max(release, n.machine_ready[flat.machine[i]]);
+                    per_machine[flat.machine[i]].push_back({release, flat.duration[i], tails[i]});
+                    release += flat.duration[i];
+                }
+                result = std::max(result, release);
+            }
+            for (auto& operations : per_machine) result = std::max(result, jackson_preemptive(operations, heap));
+            return result;
+        }
+
+        void branch(const node& n, std::vector<node>& children) const {
+            size_t earliest_job = flat.task_count;
+            uint32_t earliest_completion = UINT32_MAX;
+            for (size_t job = 0; job < flat.task_count; job++) {
+                if (n.next[job] == flat.machine_count) continue;
+                const size_t i = flat.index(job, n.next[job]);
+                const uint32_t start = std::max(n.job_ready[job], n.machine_ready[flat.machine[i]]);
+                const uint32_t completion = start + flat.duration[i];
+                if (completion < earliest_completion) earliest_completion = completion, earliest_job = job;
+            }
+            const int16_t machine = flat.machine[flat.index(earliest_job, n.next[earliest_job])];
+            for (size_t job = 0; job < flat.task_count; job++) {
+                if (n.next[job] == flat.machine_count) continue;
+                const size_t i = flat.index(job, n.next[job]);
+                if (flat.machine[i] != machine) continue;
+                const uint32_t start = std::max(n.job_ready[job], n.machine_ready[machine]);
+                if (start >= earliest_completion and job != earliest_job) continue;
+                node& child = children.emplace_back(n);
+                const uint32_t end = start + flat.duration[i];
+                child.start[i] = start;
+                child.job_ready[job] = child.machine_ready[machine] = end;
+                child.next[job]++;
+                child.makespan = std::max(child.makespan, end);
+                child.depth++;
+                if (options.deterministic) child.path.push_back((uint16_t) job);
+                child.bound = lower_bound(child);
+            }
+        }
+
+        void offer(const node& leaf) {
+            uint32_t current = upper.load();
+            while (leaf.makespan < current and not upper.compare_exchange_weak(current, leaf.makespan));
+            if (leaf.makespan > current or (leaf.makespan == current and not options.deterministic)) return;
+            std::lock_guard lock(best_mutex);
+            if (leaf.makespan > best_makespan) return;
+            // The heuristic seed has no path and loses every tie.
+            if (leaf.makespan == best_makespan and not (options.deterministic and (seeded or leaf.path < best_path)))
+                return;
+            best_makespan = leaf.makespan;
+            best_path = leaf.path;
+            seeded = false;
+            best_start = leaf.start;
+            if (options.control)
+                options.control->report(leaf.makespan, std::vector<size_t>(best_start.begin(), best_start.end()));
+        }
+
+        void explore(const node& n, thread_pool& pool) {
+            const size_t visited = ++nodes;
+            if (options.node_limit > 0 and visited > options.node_limit) stopped = true;
+            if ((visited & 1023) == 0) {
+                if (options.time_limit.count() > 0 and std::chrono::steady_clock::now() - started >= options.time_limit)
+                    stopped = true;
+                if (options.control and options.control->expired()) stopped = true;
+            }
+            if (options.control and options.control->is_cancelled()) stopped = true;
+            if (stopped.load(std::memory_order_relaxed)) return;
+            if (n.depth == flat.operation_count()) return offer(n);
+            std::vector<node> children;
+            branch(n, children);
+            std::sort(children.begin(), children.end(), [](const node& a, const node& b) { return a.bound < b.bound; });
+            for (node& child : children) {
+                const uint32_t incumbent = upper.load(std::memory_order_relaxed);
+                if (child.bound > incumbent or (child.bound == incumbent and not options.deterministic)) break;
+                if (n.depth < options.split_depth)
+                    pool.submit([this, &pool, child = std::move(child)] { explore(child, pool); });
+                else explore(child, pool);
+            }
+        }
+
+    public:
+
+        // Fills the empty `result`. The incumbent starts from the stachu heuristic, so a stopped search still
+        // returns at least that schedule.
+        branch_and_bound_result run(const dataset& data, schedule& result, const branch_and_bound_options& settings) {
+            options = settings;
+            started = std::chrono::steady_clock::now();
+            flat = flat_dataset::from_dataset(data);
+            tails.assign(flat.operation_count(), 0);
+            for (size_t job = 0; job < flat.task_count; job++)
+                for (size_t op = flat.machine_count; op-- > 1;)
+                    tails[flat.index(job, op - 1)] = tails[flat.index(job, op)] + flat.duration[flat.index(job, op)];
+
+            schedule seed(data);
+            dispatch<stachu_rule>(data, seed);
+            upper = best_makespan = (uint32_t) seed.makespan();
+            best_path.clear();
+            seeded = true;
+            if (options.control) options.control->report(seed.makespan(), seed.start_times());
+            best_start.clear();
+            for (const task& t : data.tasks)
+                for (const sub_task& st : t.sequence) best_start.push_back((uint32_t) seed.start(st));
+
+            node root;
+            root.next.assign(flat.task_count, 0);
+            root.job_ready.assign(flat.task_count, 0);
+            root.machine_ready.assign(flat.machine_count, 0);
+            root.start.assign(flat.operation_count(), 0);
+            root.bound = lower_bound(root);
+            nodes = 0;
+            stopped = false;
+            if (root.bound < upper or (options.deterministic and root.bound == upper)) {
+                thread_pool pool(options.threads, options.pin);
+                pool.submit([&] { explore(root, pool); });
+                pool.wait();
+            }
+
+            branch_and_bound_result summary;
+            summary.makespan = upper;
+            summary.root_bound = root.bound;
+            summary.nodes = options.node_limit > 0 ? std::min<size_t>(nodes, options.node_limit) : nodes.load();
+            summary.optimal = not stopped;
+            summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            result.assign_starts(std::vector<size_t>(best_start.begin(), best_start.end()));
+            return summary;
+        }
+    };
+}
+
+#endif //JOB_SHOP_BRANCH_AND_BOUND
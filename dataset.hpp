@@ -1,54 +1,251 @@
 #ifndef JOB_SHOP_DATASET
 #define JOB_SHOP_DATASET
 
-#include <fstream>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
+#include "binary_format.hpp"
+#include "text_reader.hpp"
 
 namespace js {
 
     struct task;
 
     struct sub_task {
-        int16_t machine_id = -1, task_id = -1;
-        size_t duration = 0, scheduled_time = -1;
+        int16_t machine_id = -1, task_id = -1, position = -1;
+        size_t duration = 0;
+    };
+
+    // One machine a flexible operation may run on, and how long it takes there.
+    struct alternative {
+        int16_t machine_id = -1;
+        size_t duration = 0;
     };
 
     struct task {
         int16_t id = -1;
         std::vector<sub_task> sequence;
-        size_t last_scheduled_time = 0;
+        // Flexible instances only: the alternatives of operation `j` are
+        // `dataset::alternatives[alternative_offsets[j], alternative_offsets[j + 1])`.
+        std::vector<uint32_t> alternative_offsets;
     };
 
+    // A classic instance fixes every operation to `machine_id` and `duration`. A flexible one also lists
+    // alternatives per operation, kept beside the `sub_task`s so those stay compact; there `machine_id` and
+    // `duration` hold the current routing, the first alternative until a dispatcher picks another.
     struct dataset {
         size_t machine_count = 0;
         std::vector<task> tasks;
+        std::vector<alternative> alternatives;
 
+        // Reads either format, telling them apart by the binary magic.
         static dataset from_file(const char* path) {
-            std::ifstream file(path);
-            if (not file.is_open()) throw std::runtime_error("Could not open file " + std::string(path));
+            const std::string_view name(path);
+            if (name.size() > 4 and name.substr(name.size() - 4) == ".fjs")
+                return parse_flexible(text_reader::read_file(path), path);
+            return from_bytes(text_reader::read_file(path), path);
+        }
+
+        static dataset from_bytes(std::string_view bytes, const std::string& source = "<input>") {
+            if (has_binary_magic(bytes, binary_instance_magic)) return from_binary(bytes);
+            return parse(bytes, source);
+        }
+
+        static dataset from_binary(std::string_view bytes) {
+            const binary_header header = read_binary_header(bytes, binary_instance_magic, sizeof(binary_operation));
+            if (header.task_count > (uint32_t) std::numeric_limits<int16_t>::max() or
+                header.machine_count > (uint32_t) std::numeric_limits<int16_t>::max())
+                throw std::runtime_error("Binary instance too large");
+            const binary_operation* operations = binary_records<binary_operation>(bytes);
             dataset result;
-            size_t task_count;
-            file >> task_count;
-            file >> result.machine_count;
+            result.machine_count = header.machine_count;
+            result.tasks.resize(header.task_count);
+            for (size_t i = 0; i < header.task_count; i++) {
+                task& t = result.tasks[i];
+                t.id = (int16_t) i;
+                t.sequence.resize(header.machine_count);
+                for (size_t j = 0; j < header.machine_count; j++) {
+                    const binary_operation& operation = operations[i * header.machine_count + j];
+                    if (operation.machine >= header.machine_count)
+                        throw std::runtime_error("Binary instance machine id out of range");
+                    t.sequence[j] = {(int16_t) operation.machine, (int16_t) i, (int16_t) j, operation.duration};
+                }
+            }
+            return result;
+        }
+
+        // Builds an instance from row-major arrays without touching the file system: operation `j` of job `i` runs on
+        // `machines[i * machine_count + j]` for `durations[i * machine_count + j]`.
+        static dataset from_arrays(size_t task_count, size_t machine_count, std::span<const uint16_t> machines,
+                                   std::span<const size_t> durations) {
+            if (task_count > (size_t) std::numeric_limits<int16_t>::max() or
+                machine_count > (size_t) std::numeric_limits<int16_t>::max())
+                throw std::runtime_error("Instance too large");
+            if (machines.size() != task_count * machine_count or durations.size() != machines.size())
+                throw std::runtime_error("Instance arrays do not hold task_count * machine_count operations");
+            dataset result;
+            result.machine_count = machine_count;
+            result.tasks.resize(task_count);
             for (size_t i = 0; i < task_count; i++) {
-                task t;
+                task& t = result.tasks[i];
                 t.id = (int16_t) i;
+                t.sequence.resize(machine_count);
+                for (size_t j = 0; j < machine_count; j++) {
+                    const size_t k = i * machine_count + j;
+                    if (machines[k] >= machine_count) throw std::runtime_error("Instance machine id out of range");
+                    t.sequence[j] = {(int16_t) machines[k], (int16_t) i, (int16_t) j, durations[k]};
+                }
+            }
+            return result;
+        }
+
+        // Parses `task_count machine_count` followed by `(machine duration)*` for every job.
+        static dataset parse(std::string_view text, const std::string& source = "<input>") {
+            text_reader reader(text, source);
+            dataset result;
+            const auto task_count = reader.read<uint16_t>("task count");
+            if (task_count > std::numeric_limits<int16_t>::max()) reader.fail("task count out of range");
+            result.machine_count = reader.read<uint16_t>("machine count");
+            if (result.machine_count > (size_t) std::numeric_limits<int16_t>::max())
+                reader.fail("machine count out of range");
+            result.tasks.resize(task_count);
+            for (size_t i = 0; i < task_count; i++) {
+                task& t = result.tasks[i];
+                t.id = (int16_t) i;
+                t.sequence.resize(result.machine_count);
                 for (size_t j = 0; j < result.machine_count; j++) {
-                    sub_task st;
-                    file >> st.machine_id;
-                    file >> st.duration;
+                    sub_task& st = t.sequence[j];
+                    const auto machine_id = reader.read<uint16_t>("machine id");
+                    if (machine_id >= result.machine_count) reader.fail("machine id out of range");
+                    st.machine_id = (int16_t) machine_id;
+                    st.duration = reader.read<size_t>("duration");
                     st.task_id = (int16_t) i;
-                    t.sequence.push_back(st);
+                    st.position = (int16_t) j;
+                }
+            }
+            return result;
+        }
+
+        // Parses the flexible format of the Brandimarte and Hurink benchmarks: `task_count machine_count`, anything
+        // else on that line ignored, then per job its operation count followed, per operation, by the number of
+        // alternatives and that many `machine duration` pairs with machines numbered from 1.
+        static dataset parse_flexible(std::string_view text, const std::string& source = "<input>") {
+            text_reader reader(text, source);
+            dataset result;
+            const auto task_count = reader.read<uint16_t>("task count");
+            if (task_count > std::numeric_limits<int16_t>::max()) reader.fail("task count out of range");
+            result.machine_count = reader.read<uint16_t>("machine count");
+            if (result.machine_count > (size_t) std::numeric_limits<int16_t>::max())
+                reader.fail("machine count out of range");
+            reader.skip_line();
+            result.tasks.resize(task_count);
+            for (size_t i = 0; i < task_count; i++) {
+                task& t = result.tasks[i];
+                t.id = (int16_t) i;
+                const auto operation_count = reader.read<uint16_t>("operation count");
+                if (operation_count > std::numeric_limits<int16_t>::max()) reader.fail("operation count out of range");
+                t.sequence.resize(operation_count);
+                t.alternative_offsets.push_back((uint32_t) result.alternatives.size());
+                for (size_t j = 0; j < operation_count; j++) {
+                    const auto choices = reader.read<uint16_t>("alternative count");
+                    if (choices == 0) reader.fail("operation without machines");
+                    for (size_t k = 0; k < choices; k++) {
+                        const auto machine = reader.read<uint16_t>("machine id");
+                        if (machine == 0 or machine > result.machine_count) reader.fail("machine id out of range");
+                        result.alternatives.push_back({(int16_t) (machine - 1), reader.read<size_t>("duration")});
+                    }
+                    t.alternative_offsets.push_back((uint32_t) result.alternatives.size());
+                    const alternative& first = result.alternatives[t.alternative_offsets[j]];
+                    t.sequence[j] = {first.machine_id, (int16_t) i, (int16_t) j, first.duration};
                 }
-                result.tasks.push_back(t);
             }
             return result;
         }
 
-        task& get_task(int16_t id) {
-            return *std::find_if(tasks.begin(), tasks.end(),
-                                 [&](const auto& item) { return item.id == id; });
+        [[nodiscard]] bool is_flexible() const { return not alternatives.empty(); }
+
+        // Machines `operation` may run on; empty for the fixed operations of a classic instance.
+        [[nodiscard]] std::span<const alternative> alternatives_of(const sub_task& operation) const {
+            const std::vector<uint32_t>& offsets = tasks[operation.task_id].alternative_offsets;
+            if (offsets.empty()) return {};
+            return {alternatives.data() + offsets[operation.position],
+                    alternatives.data() + offsets[operation.position + 1]};
+        }
+
+        // Every job has `machine_count` operations, the shape the classic formats and the flat layout need.
+        [[nodiscard]] bool is_rectangular() const {
+            for (const task& t : tasks) if (t.sequence.size() != machine_count) return false;
+            return true;
         }
+
+        // Writes the text format `parse` reads, or the one `parse_flexible` reads for a flexible instance.
+        void write(std::ostream& out) const {
+            if (is_flexible()) {
+                out << tasks.size() << ' ' << machine_count << '\n';
+                for (const task& t : tasks) {
+                    out << t.sequence.size();
+                    for (const sub_task& st : t.sequence) {
+                        out << ' ' << alternatives_of(st).size();
+                        for (const alternative& a : alternatives_of(st))
+                            out << ' ' << a.machine_id + 1 << ' ' << a.duration;
+                    }
+                    out << '\n';
+                }
+                return;
+            }
+            out << tasks.size() << ' ' << machine_count << '\n';
+            for (const task& t : tasks) {
+                for (size_t j = 0; j < t.sequence.size(); j++)
+                    out << (j == 0 ? "" : " ") << t.sequence[j].machine_id << ' ' << t.sequence[j].duration;
+                out << '\n';
+            }
+        }
+
+        // FNV-1a over the sizes and every (machine, duration) pair, stable across runs and platforms.
+        [[nodiscard]] uint64_t fingerprint() const {
+            uint64_t hash = 0xcbf29ce484222325;
+            const auto mix = [&](uint64_t value) {
+                for (int byte = 0; byte < 8; byte++) hash = (hash ^ ((value >> (8 * byte)) & 0xff)) * 0x100000001b3;
+            };
+            mix(tasks.size());
+            mix(machine_count);
+            for (const task& t : tasks) {
+                mix(t.sequence.size());
+                for (const sub_task& st : t.sequence) {
+                    if (is_flexible()) {
+                        for (const alternative& a : alternatives_of(st))
+                            mix((uint64_t) (uint16_t) a.machine_id), mix(a.duration);
+                        continue;
+                    }
+                    mix((uint64_t) (uint16_t) st.machine_id), mix(st.duration);
+                }
+            }
+            return hash;
+        }
+
+        // Classic rectangular instances only, as `parse` produces.
+        void write_binary(std::ostream& out) const {
+            if (is_flexible() or not is_rectangular())
+                throw std::runtime_error("Binary instances must be classic, with machine_count operations per job");
+            write_binary_header(out, binary_instance_magic, tasks.size(), machine_count, 0);
+            for (const task& t : tasks)
+                for (const sub_task& st : t.sequence) {
+                    if (st.duration > std::numeric_limits<uint32_t>::max())
+                        throw std::range_error("Duration too long for the binary format");
+                    const binary_operation operation{(uint16_t) st.machine_id, 0, (uint32_t) st.duration};
+                    out.write(reinterpret_cast<const char*>(&operation), sizeof operation);
+                }
+        }
+
+        // Jobs are stored by id; reorder an index permutation instead of `tasks` itself.
+        task& get_task(int16_t id) { return tasks[id]; }
+
+        [[nodiscard]] const task& get_task(int16_t id) const { return tasks[id]; }
     };
 }
 
@@ -0,0 +1,117 @@
+#ifndef JOB_SHOP_DISJUNCTIVE_GRAPH
+#define JOB_SHOP_DISJUNCTIVE_GRAPH
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "dataset.hpp"
+#include "schedule.hpp"
+
+namespace js {
+
+    // Operations numbered job by job, with job-precedence and per-machine order arcs as predecessor/successor
+    // index arrays. Zero-length operations only take part in job order. Heads and tails are longest paths from the
+    // source and to the sink, so heads are the start times of the semi-active schedule the orders describe.
+    struct disjunctive_graph {
+        static constexpr int32_t none = -1;
+
+        std::vector<const sub_task*> operations;
+        std::vector<size_t> duration, head, tail;
+        std::vector<int32_t> job_prev, job_next, machine_prev, machine_next;
+        std::vector<int32_t> order, waiting;
+
+        static disjunctive_graph from_schedule(const dataset& data, const schedule& schedule) {
+            disjunctive_graph result;
+            std::vector<size_t> offsets(data.tasks.size());
+            for (const task& t : data.tasks) {
+                offsets[t.id] = result.operations.size();
+                for (const sub_task& st : t.sequence) result.operations.push_back(&st);
+            }
+            const size_t n = result.operations.size();
+            result.duration.resize(n), result.head.resize(n, 0), result.tail.resize(n, 0);
+            result.job_prev.resize(n, none), result.job_next.resize(n, none);
+            result.machine_prev.resize(n, none), result.machine_next.resize(n, none), result.waiting.resize(n);
+            for (int32_t op = 0; op < (int32_t) n; op++) {
+                const sub_task& st = *result.operations[op];
+                result.duration[op] = st.duration;
+                if (st.position > 0) result.job_prev[op] = op - 1;
+                if (st.position + 1 < (int16_t) data.tasks[st.task_id].sequence.size()) result.job_next[op] = op + 1;
+            }
+            for (int16_t m = 0; m < (int16_t) data.machine_count; m++) {
+                int32_t previous = none;
+                for (const interval& busy : schedule.machine(m)) {
+                    const int32_t op = (int32_t) offsets[busy.task_id] + busy.position;
+                    result.machine_prev[op] = previous;
+                    if (previous != none) result.machine_next[previous] = op;
+                    previous = op;
+                }
+            }
+            result.evaluate();
+            return result;
+        }
+
+        [[nodiscard]] size_t size() const { return operations.size(); }
+
+        [[nodiscard]] size_t end_of(int32_t op) const { return op == none ? 0 : head[op] + duration[op]; }
+
+        [[nodiscard]] size_t chain_of(int32_t op) const { return op == none ? 0 : duration[op] + tail[op]; }
+
+        // Heads and tails by longest path in topological order, O(n); false when the machine orders form a cycle.
+        bool evaluate() {
+            const int32_t n = (int32_t) operations.size();
+            order.clear();
+            for (int32_t op = 0; op < n; op++) {
+                waiting[op] = (job_prev[op] != none) + (machine_prev[op] != none);
+                if (waiting[op] == 0) order.push_back(op);
+            }
+            for (size_t i = 0; i < order.size(); i++) {
+                const int32_t op = order[i];
+                head[op] = std::max(end_of(job_prev[op]), end_of(machine_prev[op]));
+                for (int32_t next : {job_next[op], machine_next[op]})
+                    if (next != none and --waiting[next] == 0) order.push_back(next);
+            }
+            if ((int32_t) order.size() != n) return false;
+            for (auto it = order.rbegin(); it != order.rend(); ++it)
+                tail[*it] = std::max(chain_of(job_next[*it]), chain_of(machine_next[*it]));
+            return true;
+        }
+
+        [[nodiscard]] size_t makespan() const {
+            size_t result = 0;
+            for (int32_t op = 0; op < (int32_t) operations.size(); op++) result = std::max(result, end_of(op));
+            return result;
+        }
+
+        void unlink(int32_t op) {
+            if (machine_prev[op] != none) machine_next[machine_prev[op]] = machine_next[op];
+            if (machine_next[op] != none) machine_prev[machine_next[op]] = machine_prev[op];
+            machine_prev[op] = machine_next[op] = none;
+        }
+
+        void link_after(int32_t op, int32_t previous) {
+            machine_prev[op] = previous;
+            machine_next[op] = machine_next[previous];
+            if (machine_next[previous] != none) machine_prev[machine_next[previous]] = op;
+            machine_next[previous] = op;
+        }
+
+        void link_before(int32_t op, int32_t next) {
+            machine_next[op] = next;
+            machine_prev[op] = machine_prev[next];
+            if (machine_prev[next] != none) machine_next[machine_prev[next]] = op;
+            machine_prev[next] = op;
+        }
+
+        // Replaces whatever `target`, a schedule of the same dataset, holds with the heads of this graph.
+        void to_schedule(schedule& target) const {
+            target.reset();
+            std::vector<int32_t> by_start(operations.size());
+            std::iota(by_start.begin(), by_start.end(), 0);
+            std::stable_sort(by_start.begin(), by_start.end(), [&](int32_t a, int32_t b) { return head[a] < head[b]; });
+            for (int32_t op : by_start) target.add_sub_task(*operations[op], head[op]);
+        }
+    };
+}
+
+#endif //JOB_SHOP_DISJUNCTIVE_GRAPH
@@ -0,0 +1,229 @@
+#ifndef JOB_SHOP_DISPATCH
+#define JOB_SHOP_DISPATCH
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "dataset.hpp"
+#include "instrument.hpp"
+#include "random.hpp"
+#include "schedule.hpp"
+
+namespace js {
+
+    // A job's next unscheduled operation as seen by a dispatching rule. `start` and `completion` are only filled in
+    // for Giffler–Thompson rules and when routing a flexible instance, the cases that need the placement search for
+    // every job.
+    struct candidate {
+        const task* job = nullptr;
+        const sub_task* operation = nullptr;
+        size_t position = 0;
+        size_t ready = 0, start = 0, completion = 0;
+        size_t remaining_work = 0, remaining_operations = 0;
+    };
+
+    // A rule provides `bool before(const candidate&, const candidate&) const` and `giffler_thompson`. Rules that
+    // restrict the choice to the Giffler–Thompson conflict set produce active schedules; the others pick among
+    // every job's next operation. Ties keep the job with the lower id.
+
+    struct spt_rule {
+        static constexpr bool giffler_thompson = true;
+
+        bool before(const candidate& a, const candidate& b) const {
+            return a.operation->duration < b.operation->duration;
+        }
+    };
+
+    struct lpt_rule {
+        static constexpr bool giffler_thompson = true;
+
+        bool before(const candidate& a, const candidate& b) const {
+            return a.operation->duration > b.operation->duration;
+        }
+    };
+
+    struct mwkr_rule {
+        static constexpr bool giffler_thompson = true;
+
+        bool before(const candidate& a, const candidate& b) const { return a.remaining_work > b.remaining_work; }
+    };
+
+    struct mopnr_rule {
+        static constexpr bool giffler_thompson = true;
+
+        bool before(const candidate& a, const candidate& b) const {
+            return a.remaining_operations > b.remaining_operations;
+        }
+    };
+
+    struct fifo_rule {
+        static constexpr bool giffler_thompson = true;
+
+        bool before(const candidate& a, const candidate& b) const { return a.ready < b.ready; }
+    };
+
+    // Schedules jobs one after another in id order.
+    struct alex_rule {
+        static constexpr bool giffler_thompson = false;
+
+        bool before(const candidate& a, const candidate& b) const { return a.job->id < b.job->id; }
+    };
+
+    // Schedules the operations round by round, longest first. The order inside a round comes from sorting the
+    // previous round's order, so equal durations break ties exactly as the original repeated std::sort did. Jobs
+    // without an operation at a position sort last in that round.
+    class stachu_rule {
+
+        std::vector<size_t> rank;
+        size_t task_count;
+
+    public:
+
+        static constexpr bool giffler_thompson = false;
+
+        explicit stachu_rule(const dataset& data) : task_count(data.tasks.size()) {
+            size_t positions = 0;
+            for (const task& t : data.tasks) positions = std::max(positions, t.sequence.size());
+            rank.resize(positions * task_count);
+            std::vector<size_t> order(task_count);
+            std::iota(order.begin(), order.end(), 0);
+            for (size_t i = 0; i < positions; i++) {
+                const auto key = [&](size_t job) {
+                    const std::vector<sub_task>& sequence = data.tasks[job].sequence;
+                    return i < sequence.size() ? std::pair{true, sequence[i].duration} : std::pair{false, size_t{0}};
+                };
+                std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) > key(b); });
+                for (size_t k = 0; k < order.size(); k++) rank[i * task_count + order[k]] = k;
+            }
+        }
+
+        bool before(const candidate& a, const candidate& b) const {
+            if (a.position != b.position) return a.position < b.position;
+            return rank[a.position * task_count + a.job->id] < rank[b.position * task_count + b.job->id];
+        }
+    };
+
+    // Picks the best eligible candidate; ties keep the job with the lower id.
+    struct greedy_choice {
+        template<typename rule>
+        const candidate* operator()(std::vector<const candidate*>& eligible, const rule& priority) const {
+            const candidate* chosen = nullptr;
+            for (const candidate* c : eligible) if (chosen == nullptr or priority.before(*c, *chosen)) chosen = c;
+            return chosen;
+        }
+    };
+
+    // Picks uniformly among the `top_k` best eligible candidates, for randomized greedy construction.
+    template<typename generator>
+    struct randomized_choice {
+        generator& rng;
+        size_t top_k = 1;
+
+        template<typename rule>
+        const candidate* operator()(std::vector<const candidate*>& eligible, const rule& priority) const {
+            const size_t k = std::clamp<size_t>(top_k, 1, eligible.size());
+            std::partial_sort(eligible.begin(), eligible.begin() + (ptrdiff_t) k, eligible.end(),
+                              [&](const candidate* a, const candidate* b) { return priority.before(*a, *b); });
+            return eligible[std::uniform_int_distribution<size_t>(0, k - 1)(rng)];
+        }
+    };
+
+    // List scheduler over the jobs' next operations. The rule and the choice among eligible candidates are
+    // template parameters so `before` inlines into the selection loop. With `routed`, which must be the flexible
+    // dataset `data` refers to, every candidate is first routed to its alternative with the earliest completion, one
+    // placement search per alternative, so rules compare the routed machines and durations. Remaining work counts
+    // the shortest alternatives.
+    template<typename rule, typename choice = greedy_choice>
+    void dispatch(const dataset& data, schedule& schedule, const choice& choose = {}, dataset* routed = nullptr) {
+        const rule priority = [&] {
+            if constexpr (std::is_constructible_v<rule, const dataset&>) return rule(data);
+            else return rule{};
+        }();
+        const size_t task_count = data.tasks.size();
+        std::vector<size_t> next(task_count, 0), remaining_work(task_count, 0);
+        size_t remaining = 0;
+        const auto work = [&](const sub_task& operation) {
+            size_t shortest = operation.duration;
+            if (routed)
+                for (const alternative& a : data.alternatives_of(operation)) shortest = std::min(shortest, a.duration);
+            return shortest;
+        };
+        for (const task& t : data.tasks) {
+            for (const sub_task& st : t.sequence) remaining_work[t.id] += work(st);
+            remaining += t.sequence.size();
+        }
+        std::vector<candidate> candidates;
+        std::vector<const candidate*> eligible;
+        candidates.reserve(task_count);
+        eligible.reserve(task_count);
+        for (; remaining > 0; remaining--) {
+            candidates.clear();
+            for (const task& t : data.tasks) {
+                if (next[t.id] == t.sequence.size()) continue;
+                candidate& c = candidates.emplace_back();
+                c.job = &t;
+                c.position = next[t.id];
+                c.operation = &t.sequence[c.position];
+                c.ready = schedule.job_ready(t.id);
+                if (routed) {
+                    sub_task& operation = routed->tasks[t.id].sequence[c.position];
+                    c.start = schedule.earliest_start(operation);
+                    c.completion = c.start + operation.duration;
+                    sub_task trial = operation;
+                    for (const alternative& a : data.alternatives_of(operation)) {
+                        trial.machine_id = a.machine_id;
+                        trial.duration = a.duration;
+                        const size_t start = schedule.earliest_start(trial);
+                        if (start + a.duration >= c.completion) continue;
+                        c.start = start;
+                        c.completion = start + a.duration;
+                        operation.machine_id = a.machine_id;
+                        operation.duration = a.duration;
+                    }
+                } else if constexpr (rule::giffler_thompson) {
+                    c.start = schedule.earliest_start(*c.operation);
+                    c.completion = c.start + c.operation->duration;
+                }
+                c.remaining_work = remaining_work[t.id];
+                c.remaining_operations = t.sequence.size() - c.position;
+            }
+            eligible.clear();
+            if constexpr (rule::giffler_thompson) {
+                const candidate* earliest = &*std::min_element(
+                        candidates.begin(), candidates.end(),
+                        [](const candidate& a, const candidate& b) { return a.completion < b.completion; });
+                for (const candidate& c : candidates) {
+                    if (c.operation->machine_id != earliest->operation->machine_id) continue;
+                    if (c.start < earliest->completion or &c == earliest) eligible.push_back(&c);
+                }
+            } else {
+                for (const candidate& c : candidates) eligible.push_back(&c);
+            }
+            instrumentation::count(counter::dispatch_steps);
+            instrumentation::count(counter::candidates, candidates.size());
+            const candidate* chosen = choose(eligible, priority);
+            const task& job = *chosen->job;
+            if (rule::giffler_thompson or routed) schedule.add_sub_task(*chosen->operation, chosen->start);
+            else schedule.add_sub_task(*chosen->operation);
+            remaining_work[job.id] -= work(*chosen->operation);
+            next[job.id]++;
+        }
+    }
+
+    template<typename rule>
+    void dispatch_greedy(const dataset& data, schedule& schedule) { dispatch<rule>(data, schedule); }
+
+    // `schedule` is over `data`, which is routed in place.
+    template<typename rule>
+    void dispatch_flexible(dataset& data, schedule& schedule) { dispatch<rule>(data, schedule, {}, &data); }
+
+    template<typename rule>
+    void dispatch_randomized(const dataset& data, schedule& schedule, splitmix64& rng, size_t top_k) {
+        dispatch<rule>(data, schedule, randomized_choice<splitmix64>{rng, top_k});
+    }
+}
+
+#endif //JOB_SHOP_DISPATCH
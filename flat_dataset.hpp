@@ -0,0 +1,47 @@
+#ifndef JOB_SHOP_FLAT_DATASET
+#define JOB_SHOP_FLAT_DATASET
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "dataset.hpp"
+
+namespace js {
+
+    // Structure-of-arrays copy of a dataset; operation `op` of job `job` lives at `job * machine_count + op`.
+    struct flat_dataset {
+        uint16_t task_count = 0, machine_count = 0;
+        std::vector<int16_t> machine;
+        std::vector<uint16_t> duration;
+
+        [[nodiscard]] size_t index(size_t job, size_t op) const { return job * machine_count + op; }
+
+        [[nodiscard]] size_t operation_count() const { return (size_t) task_count * machine_count; }
+
+        static flat_dataset from_dataset(const dataset& data) {
+            if (data.tasks.size() > std::numeric_limits<uint16_t>::max() or
+                data.machine_count > std::numeric_limits<uint16_t>::max())
+                throw std::range_error("Dataset too large for flat layout");
+            if (not data.is_rectangular())
+                throw std::runtime_error("Flat layout needs machine_count operations per job");
+            flat_dataset result;
+            result.task_count = (uint16_t) data.tasks.size();
+            result.machine_count = (uint16_t) data.machine_count;
+            result.machine.resize(result.operation_count());
+            result.duration.resize(result.operation_count());
+            for (const task& t : data.tasks)
+                for (size_t op = 0; op < t.sequence.size(); op++) {
+                    const sub_task& st = t.sequence[op];
+                    if (st.duration > std::numeric_limits<uint16_t>::max())
+                        throw std::range_error("Duration too long for flat layout");
+                    const size_t i = result.index(t.id, op);
+                    result.machine[i] = st.machine_id;
+                    result.duration[i] = (uint16_t) st.duration;
+                }
+            return result;
+        }
+    };
+}
+
+#endif //JOB_SHOP_FLAT_DATASET
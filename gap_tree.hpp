@@ -0,0 +1,170 @@
+#ifndef JOB_SHOP_GAP_TREE
+#define JOB_SHOP_GAP_TREE
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace js {
+
+    // Idle gaps of one timeline in a treap keyed by gap start, every node also holding the longest gap below it,
+    // so the earliest gap that fits a duration is found in O(log gaps) however many busy intervals it jumps over.
+    // The gap after the last busy interval is unbounded, so a fit always exists. Nodes live in one vector and are
+    // recycled, so refilling a cleared tree does not allocate.
+    class gap_tree {
+
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+
+        struct node {
+            size_t start, end, longest;
+            uint32_t priority, left = none, right = none;
+        };
+
+        std::vector<node> nodes;
+        std::vector<uint32_t> unused;
+        uint32_t root = none, seed = 0x9e3779b9;
+
+        [[nodiscard]] size_t longest(uint32_t n) const { return n == none ? 0 : nodes[n].longest; }
+
+        void update(uint32_t n) {
+            node& x = nodes[n];
+            x.longest = std::max({x.end - x.start, longest(x.left), longest(x.right)});
+        }
+
+        uint32_t make(size_t start, size_t end) {
+            seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+            const node fresh{start, end, end - start, seed};
+            if (unused.empty()) {
+                nodes.push_back(fresh);
+                return (uint32_t) nodes.size() - 1;
+            }
+            const uint32_t n = unused.back();
+            unused.pop_back();
+            nodes[n] = fresh;
+            return n;
+        }
+
+        // Gaps starting before `key`, and the others.
+        std::pair<uint32_t, uint32_t> split(uint32_t n, size_t key) {
+            if (n == none) return {none, none};
+            if (nodes[n].start < key) {
+                const auto [left, right] = split(nodes[n].right, key);
+                nodes[n].right = left;
+                update(n);
+                return {n, right};
+            }
+            const auto [left, right] = split(nodes[n].left, key);
+            nodes[n].left = right;
+            update(n);
+            return {left, n};
+        }
+
+        uint32_t merge(uint32_t a, uint32_t b) {
+            if (a == none) return b;
+            if (b == none) return a;
+            if (nodes[a].priority > nodes[b].priority) {
+                nodes[a].right = merge(nodes[a].right, b);
+                update(a);
+                return a;
+            }
+            nodes[b].left = merge(a, nodes[b].left);
+            update(b);
+            return b;
+        }
+
+        void add(size_t start, size_t end) {
+            if (start >= end) return;
+            const auto [left, right] = split(root, start);
+            root = merge(merge(left, make(start, end)), right);
+        }
+
+        // Drops the gap starting at `start` and returns its end.
+        size_t remove(size_t start) {
+            const auto [left, rest] = split(root, start);
+            const auto [gap, right] = split(rest, start + 1);
+            const size_t end = nodes[gap].end;
+            unused.push_back(gap);
+            root = merge(left, right);
+            return end;
+        }
+
+        // Gap with the latest start not after `time`, which holds `time` if any gap does.
+        [[nodiscard]] uint32_t at_or_before(size_t time) const {
+            uint32_t found = none;
+            for (uint32_t n = root; n != none;)
+                if (nodes[n].start <= time) found = n, n = nodes[n].right;
+                else n = nodes[n].left;
+            return found;
+        }
+
+        // Moves the bounds of the gap starting at `key`; they must stay between its neighbours, so the order holds.
+        void reshape(uint32_t n, size_t key, size_t start, size_t end) {
+            if (nodes[n].start == key) nodes[n].start = start, nodes[n].end = end;
+            else reshape(key < nodes[n].start ? nodes[n].left : nodes[n].right, key, start, end);
+            update(n);
+        }
+
+        // Earliest gap starting after `time` at least `duration` long.
+        [[nodiscard]] uint32_t first_fit(uint32_t n, size_t time, size_t duration) const {
+            if (n == none or nodes[n].longest < duration) return none;
+            if (nodes[n].start <= time) return first_fit(nodes[n].right, time, duration);
+            if (const uint32_t found = first_fit(nodes[n].left, time, duration); found != none) return found;
+            if (nodes[n].end - nodes[n].start >= duration) return n;
+            return first_fit(nodes[n].right, time, duration);
+        }
+
+    public:
+
+        gap_tree() { clear(); }
+
+        void clear() {
+            nodes.clear();
+            unused.clear();
+            root = make(0, unbounded);
+        }
+
+        [[nodiscard]] bool is_free(size_t start, size_t end) const {
+            if (start >= end) return true;
+            const uint32_t gap = at_or_before(start);
+            return gap != none and nodes[gap].end >= end;
+        }
+
+        // Earliest t >= start with [t, t + duration) inside one gap.
+        [[nodiscard]] size_t next_fit(size_t start, size_t duration) const {
+            if (const uint32_t gap = at_or_before(start); gap != none and nodes[gap].end >= start + duration)
+                return start;
+            return nodes[first_fit(root, start, duration)].start;
+        }
+
+        // [start, end) has to be free; the gap holding it shrinks around it, splitting only when both sides remain.
+        void occupy(size_t start, size_t end) {
+            if (start >= end) return;
+            const node& gap = nodes[at_or_before(start)];
+            const size_t gap_start = gap.start, gap_end = gap.end;
+            if (gap_start < start) {
+                reshape(root, gap_start, gap_start, start);
+                add(end, gap_end);
+            } else if (end < gap_end) reshape(root, gap_start, end, gap_end);
+            else remove(gap_start);
+        }
+
+        // [start, end) has to be busy; it joins the gaps on either side.
+        void release(size_t start, size_t end) {
+            if (start >= end) return;
+            const uint32_t before = at_or_before(start), after = at_or_before(end);
+            const bool joins_before = before != none and nodes[before].end == start;
+            const bool joins_after = after != none and nodes[after].start == end;
+            if (joins_before) {
+                // remove() rebuilds the treap, so it has to run before reshape() reads the root.
+                const size_t gap_start = nodes[before].start, merged_end = joins_after ? remove(end) : end;
+                reshape(root, gap_start, gap_start, merged_end);
+            } else if (joins_after) reshape(root, end, start, nodes[after].end);
+            else add(start, end);
+        }
+    };
+}
+
+#endif //JOB_SHOP_GAP_TREE
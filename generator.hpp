@@ -0,0 +1,66 @@
+#ifndef JOB_SHOP_GENERATOR
+#define JOB_SHOP_GENERATOR
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "dataset.hpp"
+
+namespace js {
+
+    // Taillard's portable generator (Lewis–Goodman–Miller, a = 16807, m = 2^31 - 1, Schrage's decomposition), as
+    // used for the ta01–ta80 benchmark set.
+    class taillard_random {
+
+        int32_t seed;
+
+    public:
+
+        explicit taillard_random(int32_t seed) : seed(seed) {}
+
+        // Uniform integer in [low, high].
+        int32_t next(int32_t low, int32_t high) {
+            constexpr int32_t m = 2147483647, a = 16807, b = 127773, c = 2836;
+            const int32_t k = seed / b;
+            seed = a * (seed % b) - k * c;
+            if (seed < 0) seed += m;
+            return low + (int32_t) ((double) seed / m * (high - low + 1));
+        }
+    };
+
+    // Instance generated the way Taillard generated the job shop benchmarks: durations in [1, 99] drawn job by job
+    // from `time_seed`, then every job's machine order shuffled from the identity with `machine_seed`. With the
+    // seeds and sizes published for ta01–ta80 it reproduces those instances.
+    inline dataset taillard_instance(size_t task_count, size_t machine_count, int32_t time_seed, int32_t machine_seed) {
+        if (task_count > (size_t) std::numeric_limits<int16_t>::max() or
+            machine_count > (size_t) std::numeric_limits<int16_t>::max())
+            throw std::range_error("Instance too large");
+        if (time_seed <= 0 or machine_seed <= 0) throw std::invalid_argument("Taillard seeds must be positive");
+        taillard_random times(time_seed), machines(machine_seed);
+        dataset result;
+        result.machine_count = machine_count;
+        result.tasks.resize(task_count);
+        for (size_t i = 0; i < task_count; i++) {
+            task& t = result.tasks[i];
+            t.id = (int16_t) i;
+            t.sequence.resize(machine_count);
+            for (size_t j = 0; j < machine_count; j++) {
+                sub_task& st = t.sequence[j];
+                st.duration = (size_t) times.next(1, 99);
+                st.task_id = (int16_t) i;
+                st.position = (int16_t) j;
+            }
+        }
+        for (task& t : result.tasks) {
+            for (size_t j = 0; j < machine_count; j++) t.sequence[j].machine_id = (int16_t) j;
+            for (size_t j = 0; j < machine_count; j++) {
+                const int32_t other = machines.next((int32_t) j, (int32_t) machine_count - 1);
+                std::swap(t.sequence[j].machine_id, t.sequence[other].machine_id);
+            }
+        }
+        return result;
+    }
+}
+
+#endif //JOB_SHOP_GENERATOR
@@ -0,0 +1,200 @@
+#ifndef JOB_SHOP_GENETIC_ALGORITHM
+#define JOB_SHOP_GENETIC_ALGORITHM
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+#include "dataset.hpp"
+#include "lower_bound.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+#include "thread_pool.hpp"
+
+namespace js {
+
+    enum class decoding { active, semi_active };
+
+    struct genetic_options {
+        size_t population = 100, generations = 200, elite = 2, tournament = 2;
+        double crossover_rate = 0.9, mutation_rate = 0.2;
+        decoding decode = decoding::active;
+        placement_index placement = placement_index::none;
+        size_t threads = std::thread::hardware_concurrency();
+        // Binds the workers to cores, and gives each one its own copy of the instance.
+        bool pin = false, replicate = false;
+        uint64_t seed = 1;
+        std::chrono::milliseconds time_limit{0};
+        search_control* control = nullptr;
+    };
+
+    struct genetic_result {
+        size_t initial_makespan = 0, makespan = 0, generations = 0, evaluations = 0;
+    };
+
+    // A chromosome lists job ids with repetition: the k-th occurrence of a job stands for its k-th operation.
+    using chromosome = std::vector<uint16_t>;
+
+    // Schedules the operations in chromosome order into an emptied `schedule` over `data`. Active decoding
+    // places each operation in the earliest gap that fits; semi-active decoding appends it after the machine's
+    // last operation. `next` is scratch space of one counter per job.
+    inline size_t decode(const dataset& data, schedule& schedule, const chromosome& genes, std::vector<uint16_t>& next,
+                         decoding mode) {
+        schedule.reset();
+        next.assign(data.tasks.size(), 0);
+        for (uint16_t job : genes) {
+            const sub_task& operation = data.tasks[job].sequence[next[job]++];
+            if (mode == decoding::active) schedule.add_sub_task(operation);
+            else schedule.add_sub_task(operation, std::max(schedule.job_ready(operation.task_id),
+                                                           schedule.machine(operation.machine_id).horizon()));
+        }
+        return schedule.makespan();
+    }
+
+    // Generational GA with tournament selection, precedence-preserving crossover (POX), swap and insertion
+    // mutation, and elitism. Offspring are bred on the calling thread from one seeded generator, so the run is
+    // reproducible for any thread count; only the decoding of a generation is spread over the pool, each worker
+    // refilling its own schedule of the shared dataset. Evolution stops once the best individual reaches the lower
+    // bound.
+    class genetic_algorithm {
+
+        struct individual {
+            chromosome genes;
+            size_t makespan = -1;
+        };
+
+        struct worker : worker_replica {
+            std::vector<uint16_t> next;
+
+            using worker_replica::worker_replica;
+        };
+
+        std::vector<individual> population, offspring;
+        std::vector<uint8_t> from_first;
+        std::mt19937_64 rng;
+        genetic_options options;
+
+        [[nodiscard]] size_t random(size_t bound) { return std::uniform_int_distribution<size_t>(0, bound - 1)(rng); }
+
+        [[nodiscard]] bool chance(double probability) {
+            return std::uniform_real_distribution<double>(0, 1)(rng) < probability;
+        }
+
+        const individual& select() {
+            const individual* winner = &population[random(population.size())];
+            for (size_t k = 1; k < options.tournament; k++) {
+                const individual& other = population[random(population.size())];
+                if (other.makespan < winner->makespan) winner = &other;
+            }
+            return *winner;
+        }
+
+        // Keeps the genes of a random subset of jobs where `first` has them and fills the remaining positions
+        // with the other jobs' genes in the order of `second`, so every job keeps its operation count.
+        void crossover(const chromosome& first, const chromosome& second, chromosome& child) {
+            for (uint8_t& keep : from_first) keep = (uint8_t) random(2);
+            child.resize(first.size());
+            size_t k = 0;
+            for (size_t i = 0; i < first.size(); i++) {
+                if (from_first[first[i]]) {
+                    child[i] = first[i];
+                    continue;
+                }
+                while (from_first[second[k]]) k++;
+                child[i] = second[k++];
+            }
+        }
+
+        void mutate(chromosome& genes) {
+            const size_t a = random(genes.size()), b = random(genes.size());
+            if (chance(0.5)) std::swap(genes[a], genes[b]);
+            else if (a < b) std::rotate(genes.begin() + (ptrdiff_t) a, genes.begin() + (ptrdiff_t) a + 1,
+                                        genes.begin() + (ptrdiff_t) b + 1);
+            else std::rotate(genes.begin() + (ptrdiff_t) b, genes.begin() + (ptrdiff_t) a,
+                             genes.begin() + (ptrdiff_t) a + 1);
+        }
+
+        // Decodes the individuals from `first` on in one chunk per worker, each worker building its state on first
+        // use.
+        void evaluate(const dataset& data, std::vector<individual>& individuals, size_t first, thread_pool& pool,
+                      worker_local<worker>& workers) {
+            const size_t count = individuals.size() - first, chunk = (count + pool.size() - 1) / pool.size();
+            for (size_t begin = first; begin < individuals.size(); begin += chunk)
+                pool.submit([&, begin] {
+                    worker& self = workers.get(data, options.replicate, options.placement);
+                    const size_t end = std::min(begin + chunk, individuals.size());
+                    for (size_t i = begin; i < end; i++)
+                        individuals[i].makespan = decode(self.data, self.plan, individuals[i].genes, self.next,
+                                                         options.decode);
+                });
+            pool.wait();
+        }
+
+        static void sort(std::vector<individual>& individuals) {
+            std::stable_sort(individuals.begin(), individuals.end(),
+                             [](const individual& a, const individual& b) { return a.makespan < b.makespan; });
+        }
+
+    public:
+
+        // Fills `result` with the best individual found.
+        genetic_result run(const dataset& data, schedule& result, const genetic_options& settings) {
+            const auto started = std::chrono::steady_clock::now();
+            options = settings;
+            options.population = std::max<size_t>(options.population, 2);
+            options.elite = std::min(options.elite, options.population);
+            rng.seed(options.seed);
+            thread_pool pool(options.threads, options.pin);
+            worker_local<worker> workers(pool);
+            from_first.assign(data.tasks.size(), 0);
+
+            chromosome genes;
+            for (const task& t : data.tasks) genes.insert(genes.end(), t.sequence.size(), (uint16_t) t.id);
+            population.assign(options.population, {genes});
+            for (individual& member : population) std::shuffle(member.genes.begin(), member.genes.end(), rng);
+            evaluate(data, population, 0, pool, workers);
+            sort(population);
+
+            // Decodes the best individual once more when it improved, to hand its start times to the control.
+            schedule reported(data);
+            std::vector<uint16_t> next;
+            const auto report = [&] {
+                if (not options.control or population.front().makespan >= options.control->best()) return;
+                decode(data, reported, population.front().genes, next, options.decode);
+                options.control->report(reported.makespan(), reported.start_times());
+            };
+            report();
+
+            genetic_result summary;
+            summary.initial_makespan = population.front().makespan;
+            summary.evaluations = population.size();
+            offspring.resize(population.size());
+            const size_t bound = compute_lower_bounds(data).value();
+            for (; summary.generations < options.generations and population.front().makespan > bound;
+                   summary.generations++) {
+                if (options.time_limit.count() > 0 and std::chrono::steady_clock::now() - started >= options.time_limit)
+                    break;
+                if (options.control and options.control->expired()) break;
+                for (size_t i = 0; i < options.elite; i++) offspring[i] = population[i];
+                for (size_t i = options.elite; i < offspring.size(); i++) {
+                    const individual& first = select();
+                    if (chance(options.crossover_rate)) crossover(first.genes, select().genes, offspring[i].genes);
+                    else offspring[i].genes = first.genes;
+                    if (chance(options.mutation_rate)) mutate(offspring[i].genes);
+                }
+                evaluate(data, offspring, options.elite, pool, workers);
+                summary.evaluations += offspring.size() - options.elite;
+                population.swap(offspring);
+                sort(population);
+                report();
+            }
+
+            summary.makespan = decode(data, result, population.front().genes, next, options.decode);
+            return summary;
+        }
+    };
+}
+
+#endif //JOB_SHOP_GENETIC_ALGORITHM
@@ -0,0 +1,104 @@
+#ifndef JOB_SHOP_GRASP
+#define JOB_SHOP_GRASP
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "algorithms.hpp"
+#include "dataset.hpp"
+#include "lower_bound.hpp"
+#include "random.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+#include "tabu_search.hpp"
+#include "thread_pool.hpp"
+
+namespace js {
+
+    struct grasp_options {
+        size_t restarts = 64, top_k = 3;
+        size_t threads = std::thread::hardware_concurrency();
+        uint64_t seed = 1;
+        // A restart whose construction is worse than `cutoff` times the best makespan so far skips improvement.
+        double cutoff = 1.5;
+        std::optional<tabu_options> improve;
+        // Also handed to the tabu searches; restarts stop once it expires.
+        search_control* control = nullptr;
+        // When set, restarts run in epochs of `epoch`, each seeing only the best of the epochs before it, so the
+        // cut and the stop at the lower bound no longer depend on which restart finishes first.
+        bool deterministic = false;
+        size_t epoch = 16;
+        // Binds the workers to cores, and gives each one its own copy of the instance.
+        bool pin = false, replicate = false;
+    };
+
+    struct grasp_result {
+        size_t makespan = -1, best_restart = -1, restarts = 0, cut = 0;
+    };
+
+    // Fills the empty `result` with the best of independent randomized-greedy constructions, each followed by the
+    // optional tabu search, on a pool. Every restart draws from its own SplitMix stream of the seed, and of equal
+    // makespans the lowest restart wins, so each restart's outcome and the reduction do not depend on the thread
+    // that ran it. What still does by default is the cut and the skipping of restarts once the best reaches the
+    // lower bound, which read the live best; the deterministic mode reads it only between epochs, for
+    // bit-identical results at any thread count as long as no wall-clock limit stops a search early. Workers build
+    // their own schedule on first use, reset between restarts; start times are copied out under a lock only on
+    // improvement.
+    inline grasp_result grasp(const dataset& data, schedule& result, const named_algorithm& algorithm,
+                              const grasp_options& options) {
+        thread_pool pool(options.threads, options.pin);
+        worker_local<worker_replica> workers(pool);
+
+        const size_t bound = compute_lower_bounds(data).value();
+        std::atomic<size_t> best = -1, cut = 0, started = 0;
+        std::mutex best_mutex;
+        grasp_result summary;
+        std::vector<size_t> best_starts;
+        std::optional<tabu_options> improve = options.improve;
+        if (improve) improve->control = options.control;
+        const size_t epoch = options.deterministic ? std::max<size_t>(options.epoch, 1) : options.restarts;
+        for (size_t first = 0; first < options.restarts; first += epoch) {
+            const size_t reference = best.load();
+            if (options.deterministic and reference <= bound) break;
+            if (options.deterministic and options.control and options.control->expired()) break;
+            for (size_t restart = first; restart < std::min(first + epoch, options.restarts); restart++)
+                pool.submit([&, restart] {
+                    const size_t known = options.deterministic ? reference : best.load(std::memory_order_relaxed);
+                    if (known <= bound) return;
+                    if (not options.deterministic and options.control and options.control->expired()) return;
+                    started++;
+                    worker_replica& self = workers.get(data, options.replicate);
+                    schedule& candidate = self.plan;
+                    candidate.reset();
+                    splitmix64 rng(stream_seed(options.seed, restart));
+                    algorithm.randomized(self.data, candidate, rng, options.top_k);
+                    const size_t constructed = candidate.makespan();
+                    if (options.control) options.control->report(constructed, candidate.start_times());
+                    if ((double) constructed > options.cutoff * (double) known) {
+                        cut++;
+                        return;
+                    }
+                    if (improve) tabu_search().run(self.data, candidate, *improve);
+                    const size_t makespan = candidate.makespan();
+                    if (makespan > best.load()) return;
+                    std::lock_guard lock(best_mutex);
+                    const bool later = makespan == summary.makespan and restart > summary.best_restart;
+                    if (makespan > summary.makespan or later) return;
+                    summary.makespan = makespan;
+                    summary.best_restart = restart;
+                    best_starts = candidate.start_times();
+                    best.store(makespan);
+                });
+            pool.wait();
+        }
+
+        summary.restarts = started;
+        summary.cut = cut;
+        if (not best_starts.empty()) result.assign_starts(best_starts);
+        return summary;
+    }
+}
+
+#endif //JOB_SHOP_GRASP
@@ -0,0 +1,139 @@
+#ifndef JOB_SHOP_INSTRUMENT_COUNTERS
+#define JOB_SHOP_INSTRUMENT_COUNTERS
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+namespace js {
+
+    // Hot-path counters and phase timers, compiled in with -DJOB_SHOP_INSTRUMENT (the CMake option of the same
+    // name). Without it every call below is an empty inline function. Each thread counts into its own block, so
+    // counting never contends; totals add the blocks up.
+#ifdef JOB_SHOP_INSTRUMENT
+    inline constexpr bool instrumented = true;
+#else
+    inline constexpr bool instrumented = false;
+#endif
+
+    enum class counter {
+        start_searches,     // earliest_start calls
+        probes,             // machine and job timeline fits tried by earliest_start
+        intervals_skipped,  // busy intervals jumped over by timeline::next_fit
+        operations_placed,
+        operations_removed,
+        dispatch_steps,
+        candidates,         // next operations scored by dispatch
+        count
+    };
+
+    enum class phase { parse, construct, improve, render, count };
+
+    class instrumentation {
+
+    public:
+
+        struct block {
+            std::array<uint64_t, (size_t) counter::count> counts{};
+            std::array<uint64_t, (size_t) phase::count> nanoseconds{};
+
+            block& operator-=(const block& other) {
+                for (size_t i = 0; i < counts.size(); i++) counts[i] -= other.counts[i];
+                for (size_t i = 0; i < nanoseconds.size(); i++) nanoseconds[i] -= other.nanoseconds[i];
+                return *this;
+            }
+        };
+
+    private:
+
+        std::mutex mutex;
+        std::deque<block> blocks;
+
+        static instrumentation& global() {
+            static instrumentation instance;
+            return instance;
+        }
+
+        static block& local() {
+            thread_local block* own = [] {
+                instrumentation& all = global();
+                std::lock_guard lock(all.mutex);
+                return &all.blocks.emplace_back();
+            }();
+            return *own;
+        }
+
+    public:
+
+        static void count(counter c, uint64_t n = 1) {
+            if constexpr (instrumented) local().counts[(size_t) c] += n;
+        }
+
+        static void add_time(phase p, std::chrono::nanoseconds elapsed) {
+            if constexpr (instrumented) local().nanoseconds[(size_t) p] += (uint64_t) elapsed.count();
+        }
+
+        // What the calling thread has counted so far; the difference of two snapshots covers the work in between.
+        [[nodiscard]] static block thread_snapshot() {
+            if constexpr (instrumented) return local();
+            return {};
+        }
+
+        // One line of counters and one of phases, each after `prefix`.
+        static void write(std::ostream& os, const block& total, std::string_view prefix = {}) {
+            if constexpr (not instrumented) return;
+            static constexpr const char* counter_names[] = {"start_searches", "probes", "intervals_skipped",
+                                                            "operations_placed", "operations_removed",
+                                                            "dispatch_steps", "candidates"};
+            static constexpr const char* phase_names[] = {"parse", "construct", "improve", "render"};
+            os << prefix << "counters:";
+            for (size_t i = 0; i < total.counts.size(); i++) os << ' ' << counter_names[i] << '=' << total.counts[i];
+            os << '\n' << prefix << "phases:";
+            for (size_t i = 0; i < total.nanoseconds.size(); i++)
+                os << ' ' << phase_names[i] << '=' << (double) total.nanoseconds[i] / 1e6 << "ms";
+            os << '\n';
+        }
+
+        // Totals over all threads; meant for when the counted work has finished.
+        static void report(std::ostream& os) {
+            if constexpr (not instrumented) return;
+            block total;
+            {
+                instrumentation& all = global();
+                std::lock_guard lock(all.mutex);
+                for (const block& b : all.blocks) {
+                    for (size_t i = 0; i < total.counts.size(); i++) total.counts[i] += b.counts[i];
+                    for (size_t i = 0; i < total.nanoseconds.size(); i++) total.nanoseconds[i] += b.nanoseconds[i];
+                }
+            }
+            write(os, total);
+        }
+    };
+
+    // Adds the lifetime of the scope to a phase.
+    class scoped_phase {
+
+        phase measured;
+        std::chrono::steady_clock::time_point started;
+
+    public:
+
+        explicit scoped_phase(phase measured) : measured(measured) {
+            if constexpr (instrumented) started = std::chrono::steady_clock::now();
+        }
+
+        scoped_phase(const scoped_phase&) = delete;
+
+        scoped_phase& operator=(const scoped_phase&) = delete;
+
+        ~scoped_phase() {
+            if constexpr (instrumented) instrumentation::add_time(measured, std::chrono::steady_clock::now() - started);
+        }
+    };
+}
+
+#endif //JOB_SHOP_INSTRUMENT_COUNTERS
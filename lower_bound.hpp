@@ -0,0 +1,98 @@
+#ifndef JOB_SHOP_LOWER_BOUND
+#define JOB_SHOP_LOWER_BOUND
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "dataset.hpp"
+
+namespace js {
+
+    template<typename time>
+    struct one_machine_operation {
+        time release, remaining, tail;
+    };
+
+    // Makespan of the preemptive one-machine schedule that always runs the available operation with the longest
+    // tail (Jackson's rule), a lower bound for that machine. Sorts `operations` by release and consumes their
+    // remaining times; `heap` is scratch space.
+    template<typename time>
+    time jackson_preemptive(std::vector<one_machine_operation<time>>& operations,
+                            std::vector<one_machine_operation<time>>& heap) {
+        using operation = one_machine_operation<time>;
+        const auto by_tail = [](const operation& a, const operation& b) { return a.tail < b.tail; };
+        std::sort(operations.begin(), operations.end(),
+                  [](const operation& a, const operation& b) { return a.release < b.release; });
+        heap.clear();
+        time t = 0, result = 0;
+        for (size_t k = 0; k < operations.size() or not heap.empty();) {
+            if (heap.empty()) t = std::max(t, operations[k].release);
+            for (; k < operations.size() and operations[k].release <= t; k++) {
+                heap.push_back(operations[k]);
+                std::push_heap(heap.begin(), heap.end(), by_tail);
+            }
+            operation& top = heap.front();
+            const time until = k < operations.size() ? operations[k].release : std::numeric_limits<time>::max();
+            const time run = std::min(top.remaining, until - t);
+            t += run;
+            top.remaining -= run;
+            if (top.remaining > 0) continue;
+            result = std::max(result, t + top.tail);
+            std::pop_heap(heap.begin(), heap.end(), by_tail);
+            heap.pop_back();
+        }
+        return result;
+    }
+
+    struct lower_bounds {
+        size_t job = 0, machine = 0, jackson = 0;
+
+        [[nodiscard]] size_t value() const { return std::max({job, machine, jackson}); }
+    };
+
+    // Bounds that need no search: the longest job, the most loaded machine, and the Jackson preemptive bound of
+    // every machine with heads and tails taken along job order alone. On a flexible instance every operation
+    // counts with its shortest alternative, machines carry only the operations that cannot run elsewhere, and
+    // the total work spread evenly over all machines bounds the makespan as well.
+    inline lower_bounds compute_lower_bounds(const dataset& data) {
+        lower_bounds result;
+        const auto shortest = [&](const sub_task& st) {
+            size_t duration = st.duration;
+            for (const alternative& a : data.alternatives_of(st)) duration = std::min(duration, a.duration);
+            return duration;
+        };
+        std::vector<size_t> load(data.machine_count, 0);
+        std::vector<std::vector<one_machine_operation<size_t>>> per_machine(data.machine_count);
+        size_t total = 0;
+        for (const task& t : data.tasks) {
+            size_t length = 0;
+            for (const sub_task& st : t.sequence) length += shortest(st);
+            result.job = std::max(result.job, length);
+            total += length;
+            size_t head = 0;
+            for (const sub_task& st : t.sequence) {
+                const size_t duration = shortest(st);
+                if (data.alternatives_of(st).size() <= 1) {
+                    load[st.machine_id] += duration;
+                    if (duration > 0) per_machine[st.machine_id].push_back({head, duration, length - head - duration});
+                }
+                head += duration;
+            }
+        }
+        std::vector<one_machine_operation<size_t>> heap;
+        for (int16_t m = 0; m < (int16_t) data.machine_count; m++) {
+            result.machine = std::max(result.machine, load[m]);
+            result.jackson = std::max(result.jackson, jackson_preemptive(per_machine[m], heap));
+        }
+        if (data.machine_count > 0)
+            result.machine = std::max(result.machine, (total + data.machine_count - 1) / data.machine_count);
+        return result;
+    }
+
+    // Relative distance of a makespan above the bound, 0 when the bound is 0.
+    inline double optimality_gap(size_t makespan, size_t bound) {
+        return bound == 0 ? 0 : (double) (makespan - std::min(makespan, bound)) / (double) bound;
+    }
+}
+
+#endif //JOB_SHOP_LOWER_BOUND
@@ -1,30 +1,249 @@
-#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include "algorithms.hpp"
+#include "batch.hpp"
 #include "dataset.hpp"
+#include "generator.hpp"
+#include "instrument.hpp"
+#include "lower_bound.hpp"
+#include "mapped_file.hpp"
+#include "search_control.hpp"
+#include "service.hpp"
 #include "schedule.hpp"
+#include "solver.hpp"
 
 // http://www.cs.put.poznan.pl/mdrozdowski/dyd/ok/index.html
 
-void alex_algorithm(js::dataset& data, js::schedule& schedule) {
-    for (js::task& task : data.tasks) for (js::sub_task& sub_task : task.sequence) schedule.add_sub_task(sub_task);
+static void usage(const char* program) {
+    std::cerr << "usage: " << program << " [instance] [--algorithm name[,name...]] [tabu options]\n"
+              << "       " << program << " --batch <directory|list> [--threads n] [--format csv|json]"
+              << " [--cache directory] [--algorithm name[,name...]] [tabu options]\n"
+              << "       " << program << " [instance] --grasp restarts [--top-k k] [--seed s] [--threads n]"
+              << " [--algorithm name] [tabu options]\n"
+              << "       " << program << " [instance] --ga generations [--population n] [--decode active|semi-active]"
+              << " [--seed s] [--time-limit ms] [--threads n]\n"
+              << "       " << program << " --generate jobs machines time_seed machine_seed\n"
+              << "       " << program << " [instance] --exact [--node-limit n] [--time-limit ms] [--threads n]\n"
+              << "       " << program << " [instance] --load schedule.bin [tabu options]\n"
+              << "       " << program << " --serve <socket|-> [--threads n] [--budget ms] [solver options]\n"
+              << "output options: --no-color --intervals --save schedule.bin --save-instance instance.bin\n"
+              << "flexible: instances ending in .fjs are routed by the dispatch rule (mwkr by default), then --tabu"
+              << " resequences the routing\n"
+              << "placement: --bitset keeps a bitset of busy time units per machine, for short horizons;"
+              << " --gaps keeps a tree of idle gaps per machine, for many gaps\n"
+              << "anytime: --budget ms stops every search at the deadline, --progress prints each new best as"
+              << " 'improvement <ms> <makespan>'; Ctrl-C stops early\n"
+              << "reproducible: --deterministic makes --grasp and --exact return the same schedule for a seed at any"
+              << " --threads, unless a time limit, budget or --node-limit stops them\n"
+              << "threads: --pin binds the workers of --batch, --grasp, --ga and --exact to cores in order,"
+              << " --replicate gives every --grasp and --ga worker its own copy of the instance\n"
+              << "service: reads '<byte count>\\n<instance>' frames and answers each with 'makespan start...'"
+              << " in dataset order\n"
+              << "tabu options: --tabu [--iterations n] [--time-limit ms] [--tenure n]\n"
+              << "algorithms:";
+    for (const js::named_algorithm& algorithm : js::algorithms) std::cerr << ' ' << algorithm.name;
+    std::cerr << '\n';
 }
 
-void stachu_algorithm(js::dataset& data, js::schedule& schedule) {
-    for (int i = 0; i < data.tasks[0].sequence.size(); i++) {
-        std::sort(data.tasks.begin(), data.tasks.end(),
-                  [=](const js::task& a, const js::task& b) { return a.sequence[i].duration > b.sequence[i].duration; });
-        for (auto& task : data.tasks) schedule.add_sub_task(task.sequence[i]);
+static js::search_control* interrupted = nullptr;
+
+// Ctrl-C stops the searches, which then hand back their incumbent as if their budget had run out.
+extern "C" void on_interrupt(int) {
+    if (interrupted) interrupted->cancel();
+}
+
+static std::vector<const js::named_algorithm*> parse_algorithms(const std::string& names) {
+    std::vector<const js::named_algorithm*> result;
+    for (size_t begin = 0; begin <= names.size();) {
+        size_t end = std::min(names.find(',', begin), names.size());
+        const js::named_algorithm* algorithm = js::find_algorithm(std::string_view(names).substr(begin, end - begin));
+        if (algorithm == nullptr) throw std::runtime_error("Unknown algorithm " + names.substr(begin, end - begin));
+        result.push_back(algorithm);
+        begin = end + 1;
     }
+    return result;
 }
 
 int main(int argc, char** argv) {
-    std::string data_file = "data_from_mary.txt";
-    if (argc > 1) data_file = std::string(argv[1]);
-    js::dataset data = js::dataset::from_file(data_file.c_str());
-    js::schedule schedule(data);
-    // alex_algorithm(data, schedule);
-    stachu_algorithm(data, schedule);
-    std::cout << schedule << std::endl;
+    std::string data_file = "data_from_mary.txt", batch_source;
+    js::batch_options options;
+    options.algorithms = {js::find_algorithm("stachu")};
+    bool all_algorithms = true;
+    js::tabu_options tabu;
+    js::grasp_options grasp;
+    js::genetic_options genetic;
+    js::render_options render;
+    std::string save_schedule, load_schedule, save_instance, serve;
+    js::placement_index placement = js::placement_index::none;
+    bool progress = false;
+    std::chrono::milliseconds budget{0};
+    bool use_grasp = false, use_exact = false, use_genetic = false;
+    js::branch_and_bound_options exact;
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        if (not std::strcmp(argv[i], "--generate") and i + 4 < argc) {
+            js::taillard_instance(std::stoul(argv[i + 1]), std::stoul(argv[i + 2]), std::stoi(argv[i + 3]),
+                                  std::stoi(argv[i + 4])).write(std::cout);
+            return 0;
+        } else if (not std::strcmp(argv[i], "--batch") and has_value) batch_source = argv[++i];
+        else if (not std::strcmp(argv[i], "--serve") and has_value) serve = argv[++i];
+        else if (not std::strcmp(argv[i], "--cache") and has_value) options.cache = argv[++i];
+        else if (not std::strcmp(argv[i], "--threads") and has_value) options.threads = std::stoul(argv[++i]);
+        else if (not std::strcmp(argv[i], "--pin")) options.pin = true;
+        else if (not std::strcmp(argv[i], "--replicate")) grasp.replicate = genetic.replicate = true;
+        else if (not std::strcmp(argv[i], "--grasp") and has_value) {
+            grasp.restarts = std::stoul(argv[++i]);
+            use_grasp = true;
+        } else if (not std::strcmp(argv[i], "--ga") and has_value) {
+            genetic.generations = std::stoul(argv[++i]);
+            use_genetic = true;
+        } else if (not std::strcmp(argv[i], "--population") and has_value) genetic.population = std::stoul(argv[++i]);
+        else if (not std::strcmp(argv[i], "--decode") and has_value) {
+            const std::string mode = argv[++i];
+            if (mode == "active") genetic.decode = js::decoding::active;
+            else if (mode == "semi-active") genetic.decode = js::decoding::semi_active;
+            else return usage(argv[0]), 1;
+        } else if (not std::strcmp(argv[i], "--exact")) use_exact = true;
+        else if (not std::strcmp(argv[i], "--save") and has_value) save_schedule = argv[++i];
+        else if (not std::strcmp(argv[i], "--load") and has_value) load_schedule = argv[++i];
+        else if (not std::strcmp(argv[i], "--save-instance") and has_value) save_instance = argv[++i];
+        else if (not std::strcmp(argv[i], "--bitset")) placement = genetic.placement = js::placement_index::bitset;
+        else if (not std::strcmp(argv[i], "--gaps")) placement = genetic.placement = js::placement_index::gaps;
+        else if (not std::strcmp(argv[i], "--budget") and has_value)
+            budget = std::chrono::milliseconds(std::stoul(argv[++i]));
+        else if (not std::strcmp(argv[i], "--progress")) progress = true;
+        else if (not std::strcmp(argv[i], "--no-color")) render.color = false;
+        else if (not std::strcmp(argv[i], "--intervals")) render.intervals = true;
+        else if (not std::strcmp(argv[i], "--node-limit") and has_value) exact.node_limit = std::stoul(argv[++i]);
+        else if (not std::strcmp(argv[i], "--top-k") and has_value) grasp.top_k = std::stoul(argv[++i]);
+        else if (not std::strcmp(argv[i], "--seed") and has_value) grasp.seed = std::stoull(argv[++i]);
+        else if (not std::strcmp(argv[i], "--deterministic")) grasp.deterministic = exact.deterministic = true;
+        else if (not std::strcmp(argv[i], "--format") and has_value) {
+            const std::string format = argv[++i];
+            if (format == "csv") options.format = js::batch_format::csv;
+            else if (format == "json") options.format = js::batch_format::json;
+            else return usage(argv[0]), 1;
+        } else if (not std::strcmp(argv[i], "--algorithm") and has_value) {
+            options.algorithms = parse_algorithms(argv[++i]);
+            all_algorithms = false;
+        } else if (not std::strcmp(argv[i], "--tabu")) options.improve.emplace();
+        else if (not std::strcmp(argv[i], "--iterations") and has_value) tabu.iterations = std::stoul(argv[++i]);
+        else if (not std::strcmp(argv[i], "--time-limit") and has_value)
+            tabu.time_limit = std::chrono::milliseconds(std::stoul(argv[++i]));
+        else if (not std::strcmp(argv[i], "--tenure") and has_value) tabu.tenure = std::stoul(argv[++i]);
+        else if (argv[i][0] == '-') return usage(argv[0]), 1;
+        else data_file = argv[i];
+    }
+    if (options.improve) options.improve = tabu;
+    if (not load_schedule.empty() and (use_grasp or use_genetic or use_exact)) {
+        std::cerr << "--load starts from a saved schedule; only --tabu can improve it, not --grasp, --ga or --exact\n";
+        return 1;
+    }
+    js::solver_options solver;
+    solver.method = use_exact ? js::solver_method::exact : use_genetic ? js::solver_method::genetic
+                  : use_grasp ? js::solver_method::grasp : js::solver_method::dispatch;
+    solver.algorithm = all_algorithms ? nullptr : options.algorithms.front();
+    solver.improve = options.improve;
+    solver.grasp = grasp;
+    solver.grasp.threads = options.threads;
+    solver.genetic = genetic;
+    solver.genetic.threads = options.threads;
+    solver.genetic.seed = grasp.seed;
+    solver.genetic.time_limit = tabu.time_limit;
+    solver.exact = exact;
+    solver.exact.threads = options.threads;
+    solver.exact.time_limit = tabu.time_limit;
+    solver.grasp.pin = solver.genetic.pin = solver.exact.pin = options.pin;
+    if (not serve.empty()) {
+        js::service_options service{solver, options.threads, placement};
+        service.budget = budget;
+        js::solver_service daemon(service);
+        if (serve == "-") daemon.serve(STDIN_FILENO, STDOUT_FILENO);
+        else daemon.listen(serve);
+        return 0;
+    }
+    if (not batch_source.empty()) {
+        if (all_algorithms) {
+            options.algorithms.clear();
+            for (const js::named_algorithm& algorithm : js::algorithms) options.algorithms.push_back(&algorithm);
+        }
+        js::run_batch(js::batch_instances(batch_source), options, std::cout);
+        js::instrumentation::report(std::cerr);
+        return 0;
+    }
+    const js::dataset data = [&] {
+        js::scoped_phase timed(js::phase::parse);
+        return js::dataset::from_file(data_file.c_str());
+    }();
+    // A flexible instance is routed on a copy, which the schedule and the later stages then treat as classic.
+    js::dataset routed;
+    if (data.is_flexible()) {
+        routed = data;
+        if (placement == js::placement_index::none) placement = js::placement_index::gaps;
+    }
+    js::schedule schedule(data.is_flexible() ? routed : data, placement);
+    if (not save_instance.empty()) {
+        std::ofstream file(save_instance, std::ios::binary);
+        data.write_binary(file);
+    }
+    js::search_control control(budget, [&](const js::improvement& found) {
+        if (progress) std::cout << "improvement " << found.elapsed.count() * 1000 << ' ' << found.makespan << std::endl;
+    });
+    interrupted = &control;
+    std::signal(SIGINT, on_interrupt);
+    const auto solve_started = std::chrono::steady_clock::now();
+    js::solver_result result;
+    solver.control = &control;
+    if (not load_schedule.empty()) {
+        std::optional<js::scoped_phase> timed(js::phase::construct);
+        schedule.read_binary(js::mapped_file(load_schedule.c_str()).bytes());
+        timed.emplace(js::phase::improve);
+        if (solver.improve) {
+            solver.improve->control = &control;
+            result.tabu = js::tabu_search().run(data.is_flexible() ? routed : data, schedule, *solver.improve);
+        }
+    } else {
+        result = data.is_flexible() ? js::solve_flexible(routed, schedule, solver)
+                                    : js::solve(data, schedule, solver);
+    }
+    if (const auto& stats = result.exact)
+        std::cerr << "exact: " << stats->makespan << (stats->optimal ? " optimal" : " best found")
+                  << ", root bound " << stats->root_bound << ", " << stats->nodes << " nodes in " << stats->seconds
+                  << " s (" << (size_t) stats->nodes_per_second() << " nodes/s)\n";
+    if (const auto& stats = result.genetic)
+        std::cerr << "ga: " << stats->initial_makespan << " -> " << stats->makespan << " after "
+                  << stats->generations << " generations, " << stats->evaluations << " decodes\n";
+    if (const auto& stats = result.grasp)
+        std::cerr << "grasp: best " << stats->makespan << " from restart " << stats->best_restart << ", "
+                  << stats->cut << " of " << stats->restarts << " restarts cut after construction\n";
+    if (const auto& stats = result.tabu)
+        std::cerr << "tabu: " << stats->initial_makespan << " -> " << stats->makespan << " after "
+                  << stats->iterations << " iterations, " << stats->evaluated_moves << " moves evaluated\n";
+    const std::chrono::duration<double, std::milli> solve_time = std::chrono::steady_clock::now() - solve_started;
+    const js::lower_bounds bounds = js::compute_lower_bounds(data);
+    std::cerr << "makespan " << schedule.makespan() << ", lower bound " << bounds.value() << " (job " << bounds.job
+              << ", machine " << bounds.machine << ", jackson " << bounds.jackson << "), gap "
+              << 100 * js::optimality_gap(schedule.makespan(), bounds.value()) << "%, " << solve_time.count()
+              << " ms\n";
+    std::optional<js::scoped_phase> timed(js::phase::render);
+    if (not save_schedule.empty()) {
+        std::ofstream file(save_schedule, std::ios::binary);
+        schedule.write_binary(file);
+    }
+    schedule.render(std::cout, render);
+    std::cout << std::endl;
     std::cout << schedule.summary() << std::endl;
+    timed.reset();
+    if constexpr (js::instrumented) {
+        size_t operations = 0;
+        for (const js::task& t : data.tasks) operations += t.sequence.size();
+        std::cerr << "instance: " << data.tasks.size() << " jobs, " << data.machine_count << " machines, "
+                  << operations << " operations, makespan " << schedule.makespan() << '\n';
+    }
+    js::instrumentation::report(std::cerr);
     return 0;
 }
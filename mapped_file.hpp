@@ -0,0 +1,61 @@
+#ifndef JOB_SHOP_MAPPED_FILE
+#define JOB_SHOP_MAPPED_FILE
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JOB_SHOP_HAS_MMAP 1
+#else
+#include "text_reader.hpp"
+#endif
+
+namespace js {
+
+    // Read-only memory map of a whole file, for reading binary records in place. Without POSIX mmap the file is
+    // read into memory instead.
+    class mapped_file {
+
+#ifdef JOB_SHOP_HAS_MMAP
+        void* address = nullptr;
+        size_t length = 0;
+#else
+        std::string contents;
+#endif
+
+    public:
+
+#ifdef JOB_SHOP_HAS_MMAP
+        explicit mapped_file(const char* path) {
+            const int descriptor = ::open(path, O_RDONLY);
+            if (descriptor < 0) throw std::runtime_error("Could not open file " + std::string(path));
+            struct stat status{};
+            if (::fstat(descriptor, &status) == 0) length = (size_t) status.st_size;
+            if (length > 0) address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            ::close(descriptor);
+            if (address == MAP_FAILED) throw std::runtime_error("Could not map file " + std::string(path));
+        }
+
+        ~mapped_file() {
+            if (address != nullptr) ::munmap(address, length);
+        }
+
+        [[nodiscard]] std::string_view bytes() const { return {static_cast<const char*>(address), length}; }
+#else
+        explicit mapped_file(const char* path) : contents(text_reader::read_file(path)) {}
+
+        [[nodiscard]] std::string_view bytes() const { return contents; }
+#endif
+
+        mapped_file(const mapped_file&) = delete;
+
+        mapped_file& operator=(const mapped_file&) = delete;
+    };
+}
+
+#endif //JOB_SHOP_MAPPED_FILE
@@ -0,0 +1,76 @@
+#ifndef JOB_SHOP_OCCUPANCY
+#define JOB_SHOP_OCCUPANCY
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace js {
+
+    // Time-indexed busy set with one bit per time unit, the optional index of a `timeline`. Window tests and
+    // free-window searches work a 64-bit word at a time: masks for the partial words at the edges, and
+    // std::countr_zero to jump to the next free or busy unit. Cost follows the words spanned rather than the
+    // intervals crossed, which wins when operations are a few units long; memory grows with the horizon.
+    class occupancy {
+
+        static constexpr size_t bits = 64;
+
+        std::vector<uint64_t> words;
+
+        [[nodiscard]] static uint64_t mask_from(size_t bit) { return ~uint64_t(0) << bit; }
+
+        [[nodiscard]] uint64_t word(size_t i) const { return i < words.size() ? words[i] : 0; }
+
+        // First unit at or after `time` whose bit equals `busy`.
+        [[nodiscard]] size_t next(size_t time, bool busy) const {
+            size_t i = time / bits;
+            uint64_t current = (busy ? word(i) : ~word(i)) & mask_from(time % bits);
+            while (current == 0) {
+                if (++i >= words.size()) return busy ? (size_t) -1 : std::max(time, words.size() * bits);
+                current = busy ? words[i] : ~words[i];
+            }
+            return i * bits + (size_t) std::countr_zero(current);
+        }
+
+        void assign(size_t start, size_t end, bool busy) {
+            if (start >= end) return;
+            if (busy and words.size() * bits < end) words.resize((end + bits - 1) / bits, 0);
+            end = std::min(end, words.size() * bits);
+            for (size_t i = start / bits; i * bits < end; i++) {
+                uint64_t mask = ~uint64_t(0);
+                if (i == start / bits) mask &= mask_from(start % bits);
+                if (i == (end - 1) / bits and end % bits != 0) mask &= ~mask_from(end % bits);
+                words[i] = busy ? words[i] | mask : words[i] & ~mask;
+            }
+        }
+
+    public:
+
+        void insert(size_t start, size_t end) { assign(start, end, true); }
+
+        void erase(size_t start, size_t end) { assign(start, end, false); }
+
+        void clear() { words.clear(); }
+
+        [[nodiscard]] bool is_free(size_t start, size_t end) const {
+            if (start >= end) return true;
+            const size_t busy = next(start, true);
+            return busy == (size_t) -1 or busy >= end;
+        }
+
+        // Earliest t >= start with [t, t + duration) free: skip to the next free unit, and if the following busy
+        // unit comes too early, start over past it.
+        [[nodiscard]] size_t next_fit(size_t start, size_t duration) const {
+            if (duration == 0) return start;
+            while (true) {
+                start = next(start, false);
+                const size_t busy = next(start, true);
+                if (busy == (size_t) -1 or busy - start >= duration) return start;
+                start = busy;
+            }
+        }
+    };
+}
+
+#endif //JOB_SHOP_OCCUPANCY
@@ -0,0 +1,41 @@
+#ifndef JOB_SHOP_RANDOM
+#define JOB_SHOP_RANDOM
+
+#include <cstdint>
+#include <limits>
+
+namespace js {
+
+    // SplitMix64: one 64-bit counter and a mixing function, so a generator costs nothing to create and streams
+    // derived from one master seed are cheap and independent. Satisfies UniformRandomBitGenerator.
+    class splitmix64 {
+
+        uint64_t state;
+
+    public:
+
+        using result_type = uint64_t;
+
+        explicit splitmix64(uint64_t seed) : state(seed) {}
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() {
+            uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+    };
+
+    // Seed of stream `index` under `master`: what a SplitMix64 seeded with `master` returns on its (index + 1)-th
+    // call, computed directly, so a unit of work draws the same numbers whichever thread runs it and in whatever
+    // order.
+    [[nodiscard]] inline uint64_t stream_seed(uint64_t master, uint64_t index) {
+        return splitmix64(master + index * 0x9e3779b97f4a7c15)();
+    }
+}
+
+#endif //JOB_SHOP_RANDOM
@@ -0,0 +1,91 @@
+#ifndef JOB_SHOP_RENDER
+#define JOB_SHOP_RENDER
+
+#include <algorithm>
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "timeline.hpp"
+
+namespace js {
+
+    struct render_options {
+        bool color = true;
+        // One `[start,end) job` entry per busy interval instead of one cell per time unit.
+        bool intervals = false;
+    };
+
+    // Draws machine timelines. Every row is formatted into one reused buffer with std::to_chars and written with
+    // a single call. Ids are zero-padded to the width of the largest job id, two digits at least.
+    class renderer {
+
+        render_options options;
+        std::string row, cell;
+        size_t width = 2;
+
+        void append_number(std::string& out, size_t value, size_t digits) {
+            char text[24];
+            const auto [end, error] = std::to_chars(text, text + sizeof text, value);
+            out.append(digits > (size_t) (end - text) ? digits - (end - text) : 0, '0');
+            out.append(text, end);
+        }
+
+        void append_job(std::string& out, int16_t task_id) {
+            if (options.color) out += "\033[1;", append_number(out, 31 + task_id % 6, 0), out += 'm';
+            append_number(out, task_id, width);
+            if (options.color) out += "\033[0m";
+        }
+
+        void write_cells(const timeline& machine) {
+            const std::string empty = std::string(width, '_') + '|';
+            row += '|';
+            size_t t = 0;
+            for (const interval& busy : machine) {
+                for (; t < busy.start; t++) row += empty;
+                cell.clear();
+                append_job(cell, busy.task_id);
+                cell += '|';
+                for (; t < busy.end; t++) row += cell;
+            }
+            for (; t < machine.horizon(); t++) row += empty;
+        }
+
+        void write_intervals(const timeline& machine) {
+            for (const interval& busy : machine) {
+                row += " [";
+                append_number(row, busy.start, 0);
+                row += ',';
+                append_number(row, busy.end, 0);
+                row += ") ";
+                append_job(row, busy.task_id);
+            }
+        }
+
+    public:
+
+        explicit renderer(render_options options = {}) : options(options) {}
+
+        void write(std::ostream& os, const std::vector<timeline>& machines, size_t task_count) {
+            width = 2;
+            for (size_t largest = task_count > 0 ? task_count - 1 : 0; largest >= 100; largest /= 10) width++;
+            if (not options.intervals) {
+                row.assign(5, ' ');
+                for (size_t i = 0; i < 64; i++) append_number(row, i, width), row += ' ';
+                row += '\n';
+                os.write(row.data(), (std::streamsize) row.size());
+            }
+            for (size_t machine_id = 0; machine_id < machines.size(); machine_id++) {
+                row.clear();
+                append_number(row, machine_id, 2);
+                row += ':';
+                if (options.intervals) write_intervals(machines[machine_id]);
+                else row += ' ', write_cells(machines[machine_id]);
+                row += '\n';
+                os.write(row.data(), (std::streamsize) row.size());
+            }
+        }
+    };
+}
+
+#endif //JOB_SHOP_RENDER
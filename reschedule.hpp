@@ -0,0 +1,140 @@
+#ifndef JOB_SHOP_RESCHEDULE
+#define JOB_SHOP_RESCHEDULE
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dataset.hpp"
+#include "schedule.hpp"
+#include "timeline.hpp"
+
+namespace js {
+
+    // Operations whose start changed, and operations newly placed, by one update.
+    struct repair_result {
+        size_t moved = 0, placed = 0;
+    };
+
+    // A schedule kept up to date while the shop runs. It owns its dataset, so jobs can be appended, and repairs
+    // locally: only the operations an update displaces are taken out and re-placed in the earliest gap after
+    // their job predecessor, and their job successors follow only when they would now start too early. Nothing
+    // moves before `now`; an operation that started before it is frozen.
+    class rescheduler {
+
+        dataset data;
+        schedule plan;
+        size_t now = 0;
+
+        [[nodiscard]] bool frozen(const sub_task& operation) const {
+            return plan.is_scheduled(operation) and plan.start(operation) < now;
+        }
+
+        [[nodiscard]] size_t earliest(const sub_task& operation) const {
+            size_t from = now;
+            if (const sub_task* previous = plan.job_predecessor(operation))
+                from = std::max(from, plan.start(*previous) + previous->duration);
+            return plan.earliest_start(operation, from);
+        }
+
+        // Takes the displaced operations out, then puts them back in order of their old starts, each followed by
+        // the part of its job that it now overlaps.
+        repair_result repair(std::vector<const sub_task*> displaced) {
+            std::unordered_map<const sub_task*, size_t> original;
+            std::sort(displaced.begin(), displaced.end(), [&](const sub_task* a, const sub_task* b) {
+                return plan.start(*a) < plan.start(*b);
+            });
+            for (const sub_task* operation : displaced) {
+                original.emplace(operation, plan.start(*operation));
+                plan.remove_sub_task(*operation);
+            }
+            for (const sub_task* operation : displaced) {
+                if (plan.is_scheduled(*operation)) continue;
+                plan.add_sub_task(*operation, earliest(*operation));
+                const std::vector<sub_task>& sequence = data.tasks[operation->task_id].sequence;
+                for (size_t k = operation->position + 1; k < sequence.size(); k++) {
+                    const sub_task& previous = sequence[k - 1], & next = sequence[k];
+                    if (not plan.is_scheduled(next) or plan.start(next) >= plan.start(previous) + previous.duration)
+                        break;
+                    original.emplace(&next, plan.start(next));
+                    plan.remove_sub_task(next);
+                    plan.add_sub_task(next, earliest(next));
+                }
+            }
+            repair_result result;
+            for (const auto& [operation, start] : original) result.moved += plan.start(*operation) != start;
+            return result;
+        }
+
+    public:
+
+        // `initial` may be partly or fully scheduled afterwards through `current()`.
+        explicit rescheduler(dataset initial, placement_index placement = placement_index::none)
+                : data(std::move(initial)), plan(data, placement) {}
+
+        // The schedule refers to the owned dataset, which therefore must not move.
+        rescheduler(const rescheduler&) = delete;
+
+        rescheduler& operator=(const rescheduler&) = delete;
+
+        [[nodiscard]] const dataset& instance() const { return data; }
+
+        [[nodiscard]] schedule& current() { return plan; }
+
+        [[nodiscard]] const schedule& current() const { return plan; }
+
+        [[nodiscard]] size_t time() const { return now; }
+
+        // Moves the clock forward, freezing every operation started before `time`.
+        void advance(size_t time) { now = std::max(now, time); }
+
+        // Appends a job, its operations given as machine and duration in order, and places it in the earliest
+        // gaps from `now` on without moving anything else.
+        repair_result add_job(std::span<const alternative> operations) {
+            if (data.tasks.size() >= (size_t) std::numeric_limits<int16_t>::max())
+                throw std::runtime_error("Too many jobs");
+            // Checked before anything changes, so a rejected job leaves the instance and the plan as they were.
+            if (operations.size() > (size_t) std::numeric_limits<int16_t>::max())
+                throw std::runtime_error("Too many operations in a job");
+            for (const alternative& operation : operations)
+                if (operation.machine_id < 0 or (size_t) operation.machine_id >= data.machine_count)
+                    throw std::runtime_error("Machine id out of range");
+            task& job = data.tasks.emplace_back();
+            job.id = (int16_t) (data.tasks.size() - 1);
+            for (const alternative& operation : operations) {
+                const auto position = (int16_t) job.sequence.size();
+                job.sequence.push_back({operation.machine_id, job.id, position, operation.duration});
+            }
+            if (data.is_flexible()) {
+                job.alternative_offsets.push_back((uint32_t) data.alternatives.size());
+                for (const alternative& operation : operations) {
+                    data.alternatives.push_back(operation);
+                    job.alternative_offsets.push_back((uint32_t) data.alternatives.size());
+                }
+            }
+            plan.extend();
+            for (const sub_task& operation : job.sequence) plan.add_sub_task(operation, earliest(operation));
+            return {0, job.sequence.size()};
+        }
+
+        // Takes the machine down over [start, end) and re-places the unfrozen operations that overlap the window.
+        // Frozen ones keep their slot, as if they finished before the machine stopped.
+        repair_result block_machine(int16_t machine_id, size_t start, size_t end) {
+            if (machine_id < 0 or (size_t) machine_id >= data.machine_count)
+                throw std::runtime_error("Machine id out of range");
+            plan.block(machine_id, start, end);
+            std::vector<const sub_task*> displaced;
+            const timeline& machine = plan.machine(machine_id);
+            for (auto it = machine.first_ending_after(start); it != machine.end() and it->start < end; ++it) {
+                const sub_task& operation = data.tasks[it->task_id].sequence[it->position];
+                if (not frozen(operation)) displaced.push_back(&operation);
+            }
+            return repair(std::move(displaced));
+        }
+    };
+}
+
+#endif //JOB_SHOP_RESCHEDULE
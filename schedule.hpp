@@ -1,96 +1,426 @@
 #ifndef JOB_SHOP_SCHEDULE
 #define JOB_SHOP_SCHEDULE
 
+#include <algorithm>
 #include <ostream>
 #include <sstream>
+#include <utility>
 #include <vector>
 #include "dataset.hpp"
+#include "instrument.hpp"
+#include "render.hpp"
+#include "timeline.hpp"
 
 namespace js {
 
+    // Besides the timelines, the schedule keeps every operation's tail: the longest chain of work that has to run
+    // after it along job and machine order. Tails are computed on first use and from then on updated only where an
+    // insertion or removal changes them, so construction does not pay for them. The makespan is always kept.
+    // Job order is the order of `task::sequence`, as every algorithm here schedules it. Start times live here,
+    // not in the dataset, so one instance can back any number of schedules.
     class schedule {
 
-        std::vector<std::vector<int16_t>> table;
-        dataset& data;
+        static constexpr size_t unscheduled = -1;
 
-        [[nodiscard]] int16_t get_cell(int16_t machine_id, size_t time_unit) const {
-            if (time_unit >= table[machine_id].size()) return -1;
-            return table[machine_id][time_unit];
+        std::vector<timeline> machines;
+        std::vector<timeline> jobs;
+        // Per machine, windows in which it is unavailable; empty until the first `block`.
+        std::vector<timeline> downtime;
+        const dataset* data;
+        std::vector<size_t> offsets, starts, ready;
+        mutable std::vector<size_t> tails;
+        mutable std::vector<const sub_task*> pending;
+        mutable bool tails_valid = false;
+        placement_index placement = placement_index::none;
+        size_t current_makespan = 0;
+
+        [[nodiscard]] size_t index(const sub_task& task) const { return offsets[task.task_id] + task.position; }
+
+        // Free on the machine, outside its downtime, and on the job.
+        [[nodiscard]] bool is_available(const sub_task& task, size_t start) const {
+            const size_t end = start + task.duration;
+            if (not downtime.empty() and not downtime[task.machine_id].is_free(start, end)) return false;
+            return machines[task.machine_id].is_free(start, end) and jobs[task.task_id].is_free(start, end);
         }
 
-        bool is_available(const sub_task& task, size_t start) {
-            for (int16_t m = 0; m < (int16_t) table.size(); m++)
-                for (size_t t = start; t < start + task.duration; t++) {
-                    if (get_cell(task.machine_id, t) != -1 or get_cell(m, t) == task.task_id) return false;
-                }
-            return true;
+        [[nodiscard]] const sub_task* machine_neighbour(const sub_task& task, bool next) const {
+            if (task.duration == 0) return nullptr;
+            const timeline& machine = machines[task.machine_id];
+            auto it = machine.find(start(task));
+            if (next and ++it == machine.end()) return nullptr;
+            if (not next) {
+                if (it == machine.begin()) return nullptr;
+                --it;
+            }
+            return &data->tasks[it->task_id].sequence[it->position];
         }
 
-        void schedule_sub_task(std::vector<int16_t>& timeline, sub_task& task, size_t start) {
-            const size_t end = start + task.duration;
-            if (end >= timeline.size()) timeline.resize(end, -1);
-            for (size_t t = start; t < end; t++) timeline[t] = task.task_id;
-            task.scheduled_time = start;
-            data.get_task(task.task_id).last_scheduled_time = start + task.duration;
+        [[nodiscard]] size_t path_after(const sub_task* task) const {
+            return task == nullptr ? 0 : task->duration + tails[index(*task)];
+        }
+
+        void propagate_tails() const {
+            while (not pending.empty()) {
+                const sub_task& task = *pending.back();
+                pending.pop_back();
+                const size_t tail = std::max(path_after(job_successor(task)), path_after(machine_successor(task)));
+                if (tails[index(task)] == tail) continue;
+                tails[index(task)] = tail;
+                if (const sub_task* previous = job_predecessor(task)) pending.push_back(previous);
+                if (const sub_task* previous = machine_predecessor(task)) pending.push_back(previous);
+            }
+        }
+
+        void schedule_sub_task(const sub_task& task, size_t start) {
+            const interval busy{start, start + task.duration, task.task_id, task.position};
+            machines[task.machine_id].insert(busy);
+            jobs[task.task_id].insert(busy);
+            starts[index(task)] = start;
+            instrumentation::count(counter::operations_placed);
+            if (job_successor(task) == nullptr) ready[task.task_id] = busy.end;
+            current_makespan = std::max(current_makespan, busy.end);
+            if (not tails_valid) return;
+            tails[index(task)] = std::max(path_after(job_successor(task)), path_after(machine_successor(task)));
+            if (const sub_task* previous = job_predecessor(task)) pending.push_back(previous);
+            if (const sub_task* previous = machine_predecessor(task)) pending.push_back(previous);
+            propagate_tails();
+        }
+
+        // Every successor starts no earlier than its predecessor, and a job successor sharing a start comes later
+        // in the sequence, so one pass in decreasing (start, position) order sees successors first.
+        void ensure_tails() const {
+            if (tails_valid) return;
+            std::vector<const sub_task*> order;
+            for (const task& t : data->tasks)
+                for (const sub_task& st : t.sequence) if (is_scheduled(st)) order.push_back(&st);
+            std::sort(order.begin(), order.end(), [&](const sub_task* a, const sub_task* b) {
+                return start(*a) != start(*b) ? start(*a) > start(*b) : a->position > b->position;
+            });
+            for (const sub_task* task : order)
+                tails[index(*task)] = std::max(path_after(job_successor(*task)), path_after(machine_successor(*task)));
+            tails_valid = true;
         }
 
         [[nodiscard]] size_t longest_timeline() const {
             size_t result = 0;
-            for (const auto& timeline : table) result = std::max(result, timeline.size());
+            for (const auto& machine : machines) result = std::max(result, machine.horizon());
             return result;
         }
 
-        static std::string colored(const char* text, int16_t color) {
-            return "\033[1;" + std::to_string(31 + color % 6) + "m" + text + "\033[0m";
+    public:
+
+        // `placement` picks the index every machine timeline keeps, see `timeline::index`. Job timelines stay plain
+        // intervals: a job holds one operation per machine, so its scan is short, while a job bitset would span the
+        // whole horizon; indexing them too made BM_add_sub_task with the bitset a third slower.
+        explicit schedule(const dataset& data, placement_index placement = placement_index::none)
+                : data(&data), placement(placement) {
+            rebind(data);
         }
 
-    public:
+        // The schedule refers to the dataset, which therefore has to outlive it.
+        explicit schedule(dataset&&, placement_index = placement_index::none) = delete;
 
-        explicit schedule(dataset& data)
-                : table(std::vector<std::vector<int16_t>>(data.machine_count)), data(data) {}
+        [[nodiscard]] bool is_scheduled(const sub_task& task) const { return starts[index(task)] != unscheduled; }
 
-        void add_sub_task(sub_task& task) {
-            std::vector<int16_t>& timeline = table[task.machine_id];
-            size_t t = data.get_task(task.task_id).last_scheduled_time;
-            while (not is_available(task, t)) t++;
-            schedule_sub_task(timeline, task, t);
+        // Whether every operation is placed.
+        [[nodiscard]] bool is_complete() const {
+            return std::find(starts.begin(), starts.end(), unscheduled) == starts.end();
         }
 
-        friend std::ostream& operator<<(std::ostream& os, const schedule& s) {
-            char* id_string = new char[3];
-            os << "     ";
-            for (uint8_t i = 0; i < 64; i++) {
-                sprintf(id_string, "%02hd", i);
-                os << id_string << " ";
+        // Start time of a scheduled operation; `(size_t) -1` when it is not scheduled.
+        [[nodiscard]] size_t start(const sub_task& task) const { return starts[index(task)]; }
+
+        // Start of every operation in dataset order, as `assign_starts` takes them.
+        [[nodiscard]] const std::vector<size_t>& start_times() const { return starts; }
+
+        // Completion of the job's last scheduled operation, the earliest start for its next one.
+        [[nodiscard]] size_t job_ready(int16_t task_id) const { return ready[task_id]; }
+
+        // Earliest start not before the job's last completion that is free on both the machine and the job.
+        [[nodiscard]] size_t earliest_start(const sub_task& task) const {
+            return earliest_start(task, ready[task.task_id]);
+        }
+
+        // Earliest start not before `from` that is free on the machine, outside its downtime, and on the job.
+        [[nodiscard]] size_t earliest_start(const sub_task& task, size_t from) const {
+            const timeline& machine = machines[task.machine_id];
+            const timeline& job = jobs[task.task_id];
+            const timeline* down = downtime.empty() ? nullptr : &downtime[task.machine_id];
+            size_t t = from;
+            instrumentation::count(counter::start_searches);
+            while (true) {
+                instrumentation::count(counter::probes, 2);
+                t = machine.next_fit(t, task.duration);
+                if (down) {
+                    if (const size_t up = down->next_fit(t, task.duration); up != t) {
+                        t = up;
+                        continue;
+                    }
+                }
+                const size_t job_fit = job.next_fit(t, task.duration);
+                if (job_fit == t) return t;
+                t = job_fit;
             }
-            os << std::endl;
-            for (int16_t machine_id = 0; machine_id < (int16_t) s.table.size(); machine_id++) {
-                sprintf(id_string, "%02hd", machine_id);
-                os << id_string << ": ";
-                os << '|';
-                for (int16_t task_id : s.table[machine_id]) {
-                    sprintf(id_string, "%02hd", task_id);
-                    if (task_id == -1) os << "__|";
-                    else os << colored(id_string, task_id) << '|';
+        }
+
+        void add_sub_task(const sub_task& task) {
+            schedule_sub_task(task, earliest_start(task));
+        }
+
+        // Places an operation at a start chosen by the caller, who guarantees the window is free.
+        void add_sub_task(const sub_task& task, size_t start) {
+            schedule_sub_task(task, start);
+        }
+
+        // Places the operations of an empty schedule at `starts`, given job by job in sequence order; `(size_t) -1`
+        // leaves an operation unscheduled.
+        void assign_starts(const std::vector<size_t>& starts) {
+            std::vector<std::pair<size_t, const sub_task*>> by_start;
+            by_start.reserve(starts.size());
+            size_t i = 0;
+            for (const task& t : data->tasks)
+                for (const sub_task& st : t.sequence) {
+                    if (starts[i] != unscheduled) by_start.emplace_back(starts[i], &st);
+                    i++;
                 }
-                os << std::endl;
+            std::stable_sort(by_start.begin(), by_start.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (auto& [start, task] : by_start) schedule_sub_task(*task, start);
+        }
+
+        // Unschedules every operation. Timelines keep their capacity, so a schedule that is refilled over and over,
+        // as a decoder does, stops allocating after the first pass.
+        void reset() {
+            for (timeline& machine : machines) machine.clear();
+            for (timeline& job : jobs) job.clear();
+            downtime.clear();
+            std::fill(starts.begin(), starts.end(), unscheduled);
+            std::fill(ready.begin(), ready.end(), 0);
+            current_makespan = 0;
+            tails_valid = false;
+        }
+
+        // Empties the schedule and points it at another dataset, which has to outlive it, reusing the timelines and
+        // buffers already allocated; long-lived workers keep one schedule across instances this way.
+        void rebind(const dataset& other) {
+            data = &other;
+            if (machines.size() > other.machine_count) machines.resize(other.machine_count);
+            while (machines.size() < other.machine_count)
+                machines.emplace_back().index(placement);
+            jobs.resize(other.tasks.size());
+            offsets.resize(other.tasks.size());
+            size_t operation_count = 0;
+            for (const task& t : other.tasks) offsets[t.id] = operation_count, operation_count += t.sequence.size();
+            starts.resize(operation_count);
+            ready.resize(other.tasks.size());
+            tails.assign(operation_count, 0);
+            pending.clear();
+            reset();
+        }
+
+        void rebind(dataset&&) = delete;
+
+        // Takes in the jobs appended to the dataset since the schedule was built or rebound, all unscheduled;
+        // everything already placed stays where it is.
+        void extend() {
+            const size_t known = jobs.size();
+            jobs.resize(data->tasks.size());
+            offsets.resize(data->tasks.size());
+            ready.resize(data->tasks.size(), 0);
+            size_t operation_count = starts.size();
+            for (size_t i = known; i < data->tasks.size(); i++)
+                offsets[i] = operation_count, operation_count += data->tasks[i].sequence.size();
+            starts.resize(operation_count, unscheduled);
+            tails.resize(operation_count, 0);
+            tails_valid = false;
+        }
+
+        // Marks the machine unavailable over [start, end), merged with the windows already blocked. Operations
+        // placed there stay put; only later placement searches avoid the window. The disjunctive graph and with
+        // it the tabu search do not know about downtime.
+        void block(int16_t machine_id, size_t start, size_t end) {
+            if (start >= end) return;
+            if (downtime.empty()) downtime.resize(machines.size());
+            timeline& down = downtime[machine_id];
+            for (auto it = down.first_ending_after(start); it != down.end() and it->start <= end;
+                 it = down.first_ending_after(start)) {
+                const interval overlapping = *it;
+                start = std::min(start, overlapping.start);
+                end = std::max(end, overlapping.end);
+                down.erase(overlapping);
             }
-            delete[] id_string;
+            down.insert({start, end, -1, -1});
+        }
+
+        void remove_sub_task(const sub_task& task) {
+            const interval busy{start(task), start(task) + task.duration, task.task_id, task.position};
+            const sub_task* job_previous = job_predecessor(task);
+            const sub_task* machine_previous = machine_predecessor(task);
+            machines[task.machine_id].erase(busy);
+            jobs[task.task_id].erase(busy);
+            starts[index(task)] = unscheduled;
+            tails[index(task)] = 0;
+            instrumentation::count(counter::operations_removed);
+            if (job_successor(task) == nullptr)
+                ready[task.task_id] = job_previous ? start(*job_previous) + job_previous->duration : 0;
+            if (busy.end >= current_makespan) current_makespan = longest_timeline();
+            if (not tails_valid) return;
+            if (job_previous) pending.push_back(job_previous);
+            if (machine_previous) pending.push_back(machine_previous);
+            propagate_tails();
+        }
+
+        // Moves a scheduled operation to `start` if the window is free and job order is kept.
+        bool move_sub_task(const sub_task& task, size_t target) {
+            const sub_task* previous = job_predecessor(task);
+            const sub_task* next = job_successor(task);
+            if (previous and target < start(*previous) + previous->duration) return false;
+            if (next and target + task.duration > start(*next)) return false;
+            const size_t original = start(task);
+            remove_sub_task(task);
+            schedule_sub_task(task, is_available(task, target) ? target : original);
+            return start(task) == target;
+        }
+
+        [[nodiscard]] const sub_task* job_predecessor(const sub_task& task) const {
+            if (task.position == 0) return nullptr;
+            const sub_task& previous = data->tasks[task.task_id].sequence[task.position - 1];
+            return is_scheduled(previous) ? &previous : nullptr;
+        }
+
+        [[nodiscard]] const sub_task* job_successor(const sub_task& task) const {
+            const std::vector<sub_task>& sequence = data->tasks[task.task_id].sequence;
+            if (task.position + 1 >= (int16_t) sequence.size()) return nullptr;
+            const sub_task& next = sequence[task.position + 1];
+            return is_scheduled(next) ? &next : nullptr;
+        }
+
+        [[nodiscard]] const sub_task* machine_predecessor(const sub_task& task) const {
+            return machine_neighbour(task, false);
+        }
+
+        [[nodiscard]] const sub_task* machine_successor(const sub_task& task) const {
+            return machine_neighbour(task, true);
+        }
+
+        [[nodiscard]] const timeline& machine(int16_t machine_id) const { return machines[machine_id]; }
+
+        [[nodiscard]] size_t head(const sub_task& task) const { return start(task); }
+
+        [[nodiscard]] size_t tail(const sub_task& task) const {
+            ensure_tails();
+            return tails[index(task)];
+        }
+
+        [[nodiscard]] size_t makespan() const { return current_makespan; }
+
+        // Walks back from the operation finishing last through predecessors that end exactly when their
+        // successor starts and whose tail runs through it.
+        [[nodiscard]] std::vector<const sub_task*> critical_path() const {
+            ensure_tails();
+            std::vector<const sub_task*> path;
+            for (const timeline& machine : machines) {
+                if (machine.size() == 0 or std::prev(machine.end())->end != current_makespan) continue;
+                const interval& last = *std::prev(machine.end());
+                path.push_back(&data->tasks[last.task_id].sequence[last.position]);
+                break;
+            }
+            while (not path.empty()) {
+                const sub_task& task = *path.back();
+                const auto tight = [&](const sub_task* previous) {
+                    return previous and start(*previous) + previous->duration == start(task) and
+                           tails[index(*previous)] == task.duration + tails[index(task)];
+                };
+                if (const sub_task* previous = job_predecessor(task); tight(previous)) path.push_back(previous);
+                else if (const sub_task* other = machine_predecessor(task); tight(other)) path.push_back(other);
+                else break;
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        // Start times in dataset order, `binary_unscheduled` where there is none. Like instances, only classic
+        // schedules fit the format; a flexible one would lose its routing.
+        void write_binary(std::ostream& out) const {
+            if (data->is_flexible() or not data->is_rectangular())
+                throw std::runtime_error("Binary schedules must be of classic instances");
+            write_binary_header(out, binary_schedule_magic, data->tasks.size(), data->machine_count, current_makespan);
+            for (size_t start : starts) {
+                if (start != unscheduled and start >= binary_unscheduled)
+                    throw std::range_error("Start time too late for the binary format");
+                const uint32_t record = start == unscheduled ? binary_unscheduled : (uint32_t) start;
+                out.write(reinterpret_cast<const char*>(&record), sizeof record);
+            }
+        }
+
+        // Replaces the schedule with one written by `write_binary` for the same instance. Starts that break a job's
+        // order or overlap on a machine are rejected, and the schedule is then left as it was.
+        void read_binary(std::string_view bytes) {
+            const binary_header header = read_binary_header(bytes, binary_schedule_magic, sizeof(uint32_t));
+            if (header.task_count != data->tasks.size() or header.machine_count != data->machine_count or
+                (size_t) header.task_count * header.machine_count != starts.size())
+                throw std::runtime_error("Binary schedule does not match the instance");
+            const uint32_t* records = binary_records<uint32_t>(bytes);
+            std::vector<size_t> read(starts.size());
+            for (size_t i = 0; i < read.size(); i++)
+                read[i] = records[i] == binary_unscheduled ? unscheduled : records[i];
+            std::vector<std::vector<std::pair<size_t, size_t>>> busy(data->machine_count);
+            size_t i = 0;
+            for (const task& t : data->tasks) {
+                size_t job_end = 0;
+                for (const sub_task& st : t.sequence) {
+                    const size_t start = read[i++];
+                    if (start == unscheduled) continue;
+                    if (start < job_end) throw std::runtime_error("Binary schedule breaks the order of a job");
+                    job_end = start + st.duration;
+                    if (st.duration > 0) busy[st.machine_id].emplace_back(start, job_end);
+                }
+            }
+            for (auto& intervals : busy) {
+                std::sort(intervals.begin(), intervals.end());
+                for (size_t k = 1; k < intervals.size(); k++)
+                    if (intervals[k].first < intervals[k - 1].second)
+                        throw std::runtime_error("Binary schedule overlaps operations on a machine");
+            }
+            reset();
+            assign_starts(read);
+        }
+
+        void render(std::ostream& os, const render_options& options) const {
+            renderer(options).write(os, machines, data->tasks.size());
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const schedule& s) {
+            renderer().write(os, s.machines, s.data->tasks.size());
             return os;
-        };
+        }
 
         [[nodiscard]] std::string summary() const {
             std::stringstream summary;
-            summary << longest_timeline() << '\n';
-            std::vector<task>& tasks = data.tasks;
-            std::sort(tasks.begin(), tasks.end(), [](const task& a, const task& b) { return a.id < b.id; });
-            for (const auto& task : tasks) {
-                for (const auto& sub_task : task.sequence) summary << sub_task.scheduled_time << ' ';
+            summary << makespan() << '\n';
+            for (const auto& task : data->tasks) {
+                for (const auto& sub_task : task.sequence) summary << start(sub_task) << ' ';
                 summary << '\n';
             }
             return summary.str();
         };
     };
+
+    // State of one worker of a parallel search: a schedule, over the worker's own copy of the instance when
+    // `replicate` is set, so that a worker building it touches no memory of another node. Both are only valid
+    // while `shared` is.
+    struct worker_replica {
+        dataset copy;
+        const dataset& data;
+        schedule plan;
+
+        worker_replica(const dataset& shared, bool replicate, placement_index placement = placement_index::none)
+                : copy(replicate ? shared : dataset{}), data(replicate ? copy : shared), plan(data, placement) {}
+
+        worker_replica(const worker_replica&) = delete;
+
+        worker_replica& operator=(const worker_replica&) = delete;
+    };
 }
 
 #endif //JOB_SHOP_SCHEDULE
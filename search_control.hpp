@@ -0,0 +1,75 @@
+#ifndef JOB_SHOP_SEARCH_CONTROL
+#define JOB_SHOP_SEARCH_CONTROL
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace js {
+
+    // A new best schedule: its makespan, when it was found, and its start times in dataset order, ready for
+    // `schedule::assign_starts`.
+    struct improvement {
+        size_t makespan;
+        std::chrono::duration<double> elapsed;
+        const std::vector<size_t>& starts;
+    };
+
+    // Wall-clock budget, cancellation token and incumbent shared by every search of one solve. Searches poll it in
+    // their inner loops: the cancellation flag on every call and the clock only every 64th, so the check is a
+    // relaxed load most of the time. `report` keeps the best schedule any of them has found and streams each
+    // strict improvement to the callback; the caller can also take the incumbent at any moment.
+    class search_control {
+
+        using clock = std::chrono::steady_clock;
+
+        clock::time_point started = clock::now(), deadline = clock::time_point::max();
+        std::atomic<bool> cancelled{false};
+        std::function<void(const improvement&)> on_improvement;
+        mutable std::mutex incumbent_mutex;
+        std::vector<size_t> best_starts;
+        std::atomic<size_t> best_makespan = -1;
+
+    public:
+
+        // A zero budget means no deadline.
+        explicit search_control(std::chrono::milliseconds budget = std::chrono::milliseconds(0),
+                                std::function<void(const improvement&)> on_improvement = {})
+                : on_improvement(std::move(on_improvement)) {
+            if (budget.count() > 0) deadline = started + budget;
+        }
+
+        // Safe from any thread and from a signal handler.
+        void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+        [[nodiscard]] bool is_cancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] bool expired() const { return is_cancelled() or clock::now() >= deadline; }
+
+        // Cheap stop test for loops: `counter` is the caller's iteration count.
+        [[nodiscard]] bool poll(size_t counter) const {
+            return is_cancelled() or ((counter & 63) == 0 and clock::now() >= deadline);
+        }
+
+        void report(size_t makespan, const std::vector<size_t>& starts) {
+            if (makespan >= best_makespan.load(std::memory_order_relaxed)) return;
+            std::lock_guard lock(incumbent_mutex);
+            if (makespan >= best_makespan.load()) return;
+            best_makespan = makespan;
+            best_starts = starts;
+            if (on_improvement) on_improvement({makespan, clock::now() - started, best_starts});
+        }
+
+        [[nodiscard]] size_t best() const { return best_makespan.load(); }
+
+        // Start times of the best schedule reported so far; empty before the first report.
+        [[nodiscard]] std::vector<size_t> incumbent() const {
+            std::lock_guard lock(incumbent_mutex);
+            return best_starts;
+        }
+    };
+}
+
+#endif //JOB_SHOP_SEARCH_CONTROL
@@ -0,0 +1,274 @@
+#ifndef JOB_SHOP_SERVICE
+#define JOB_SHOP_SERVICE
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "dataset.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+
+// POSIX only: the service reads descriptors, polls and listens on Unix domain sockets. Only the CLI includes it,
+// so job_shop_core itself stays portable.
+
+namespace js {
+
+    struct service_options {
+        solver_options solver;
+        size_t threads = std::thread::hardware_concurrency();
+        placement_index placement = placement_index::none;
+        // Requests queued together are packed into one worker task until their payloads reach this many bytes.
+        size_t batch_bytes = 64 * 1024;
+        // Budget of every request; zero leaves only the limits of the solver stages.
+        std::chrono::milliseconds budget{0};
+        // Larger requests are answered with an error, and the conversation ends.
+        size_t max_frame_bytes = 64 * 1024 * 1024;
+    };
+
+    // Buffered reads of `<byte count>\n<payload>` frames from a pipe or socket. Payloads longer than `limit`, and
+    // headers longer than any count could be, are rejected before they are buffered.
+    class frame_reader {
+
+        static constexpr size_t max_header_bytes = 20;
+
+        int descriptor;
+        size_t limit;
+        std::string buffer;
+
+        bool fill() {
+            char chunk[1 << 16];
+            ssize_t count;
+            do count = ::read(descriptor, chunk, sizeof chunk); while (count < 0 and errno == EINTR);
+            if (count <= 0) return false;
+            buffer.append(chunk, (size_t) count);
+            return true;
+        }
+
+    public:
+
+        frame_reader(int descriptor, size_t limit) : descriptor(descriptor), limit(limit) {}
+
+        // Next payload; false at a clean end of input.
+        bool read(std::string& payload) {
+            size_t newline;
+            while ((newline = buffer.find('\n')) == std::string::npos) {
+                if (buffer.size() > max_header_bytes) throw std::runtime_error("Malformed request header");
+                if (not fill()) {
+                    if (buffer.empty()) return false;
+                    throw std::runtime_error("Truncated request header");
+                }
+            }
+            size_t length = 0;
+            const auto [end, error] = std::from_chars(buffer.data(), buffer.data() + newline, length);
+            if (error != std::errc() or end != buffer.data() + newline)
+                throw std::runtime_error("Malformed request header");
+            if (length > limit) throw std::runtime_error("Request too large");
+            while (buffer.size() - newline - 1 < length)
+                if (not fill()) throw std::runtime_error("Truncated request");
+            payload.assign(buffer, newline + 1, length);
+            buffer.erase(0, newline + 1 + length);
+            return true;
+        }
+
+        // Whether more input is already there, so reading another frame is not waiting for the client.
+        [[nodiscard]] bool ready() const {
+            if (not buffer.empty()) return true;
+            pollfd status{descriptor, POLLIN, 0};
+            return ::poll(&status, 1, 0) > 0;
+        }
+    };
+
+    // Long-running solver: one warm pool, and one schedule per worker that is rebound to every instance it solves,
+    // so a request costs neither thread creation nor, once the arenas have grown, allocation of timelines. Requests
+    // from every client go through one queue; a dispatcher drains it and packs what arrived together into at most
+    // one task per worker, bounded by `batch_bytes`, to amortize the hand-off for small instances. Each answer is
+    // the line `makespan start...` with starts in dataset order, or `error <message>`. The search stages run on one
+    // thread each, inline on the service worker; GRASP and the GA still build their own schedule for every request,
+    // so only the dispatch path reuses the arena.
+    class solver_service {
+
+        struct request {
+            std::string payload;
+            std::promise<std::string> answer;
+        };
+
+        inline static const dataset empty{};
+
+        service_options options;
+        thread_pool pool;
+        std::vector<std::unique_ptr<schedule>> arenas;
+        std::mutex queue_mutex;
+        std::condition_variable queue_ready;
+        std::vector<request> queue;
+        bool stopping = false;
+        std::thread dispatcher;
+
+        // The arena keeps pointing at the request's dataset afterwards but is only used again after a rebind.
+        std::string answer(schedule& arena, std::string_view payload) {
+            std::string line;
+            try {
+                const dataset data = dataset::from_bytes(payload);
+                arena.rebind(data);
+                search_control control(options.budget);
+                solver_options solver = options.solver;
+                solver.control = &control;
+                const size_t makespan = solve(data, arena, solver).makespan;
+                char digits[24];
+                line.append(digits, std::to_chars(digits, digits + sizeof digits, makespan).ptr);
+                for (size_t start : arena.start_times()) {
+                    line += ' ';
+                    line.append(digits, std::to_chars(digits, digits + sizeof digits, start).ptr);
+                }
+            } catch (const std::exception& failure) {
+                line = "error " + std::string(failure.what());
+                for (char& c : line) if (c == '\n') c = ' ';
+            }
+            return line + '\n';
+        }
+
+        void dispatch() {
+            std::unique_lock lock(queue_mutex);
+            while (true) {
+                queue_ready.wait(lock, [&] { return stopping or not queue.empty(); });
+                if (queue.empty()) return;
+                std::vector<request> drained;
+                drained.swap(queue);
+                lock.unlock();
+                const size_t per_task = (drained.size() + pool.size() - 1) / pool.size();
+                for (size_t begin = 0; begin < drained.size();) {
+                    auto group = std::make_shared<std::vector<request>>();
+                    for (size_t bytes = 0; begin < drained.size() and group->size() < per_task; begin++) {
+                        bytes += drained[begin].payload.size();
+                        if (not group->empty() and bytes > options.batch_bytes) break;
+                        group->push_back(std::move(drained[begin]));
+                    }
+                    pool.submit([this, group] {
+                        schedule& arena = *arenas[pool.worker_index()];
+                        for (request& r : *group) r.answer.set_value(answer(arena, r.payload));
+                    });
+                }
+                lock.lock();
+            }
+        }
+
+        static void write_all(int descriptor, std::string_view bytes) {
+            while (not bytes.empty()) {
+                const ssize_t count = ::write(descriptor, bytes.data(), bytes.size());
+                if (count < 0 and errno == EINTR) continue;
+                if (count <= 0) throw std::runtime_error("Could not write the response");
+                bytes.remove_prefix((size_t) count);
+            }
+        }
+
+    public:
+
+        // Parallelism comes from the service pool, so the stages a request runs are kept to one thread each.
+        explicit solver_service(service_options settings) : options(std::move(settings)), pool(options.threads) {
+            options.solver.grasp.threads = options.solver.genetic.threads = options.solver.exact.threads = 1;
+            for (size_t i = 0; i < pool.size(); i++)
+                arenas.push_back(std::make_unique<schedule>(empty, options.placement));
+            dispatcher = std::thread([this] { dispatch(); });
+        }
+
+        solver_service(const solver_service&) = delete;
+
+        solver_service& operator=(const solver_service&) = delete;
+
+        ~solver_service() {
+            {
+                std::lock_guard lock(queue_mutex);
+                stopping = true;
+            }
+            queue_ready.notify_all();
+            dispatcher.join();
+            pool.wait();
+        }
+
+        // Queues one instance in the text or binary format; the future holds its answer line.
+        std::future<std::string> submit(std::string payload) {
+            request r{std::move(payload), {}};
+            std::future<std::string> result = r.answer.get_future();
+            {
+                std::lock_guard lock(queue_mutex);
+                queue.push_back(std::move(r));
+            }
+            queue_ready.notify_one();
+            return result;
+        }
+
+        // Answers the frames of one client in order until its input ends. Frames that have already arrived are
+        // queued together before waiting for any answer, so a pipelining client gets its instances batched. A
+        // malformed frame is answered with an error line and ends the conversation.
+        void serve(int input, int output) {
+            frame_reader reader(input, options.max_frame_bytes);
+            std::vector<std::future<std::string>> answers;
+            std::string payload;
+            bool open = true;
+            while (open) {
+                std::string failure;
+                try {
+                    do {
+                        if (not (open = reader.read(payload))) break;
+                        answers.push_back(submit(std::move(payload)));
+                    } while (reader.ready());
+                } catch (const std::runtime_error& error) {
+                    failure = "error " + std::string(error.what()) + '\n';
+                    open = false;
+                }
+                for (std::future<std::string>& answer : answers) write_all(output, answer.get());
+                answers.clear();
+                if (not failure.empty()) write_all(output, failure);
+            }
+        }
+
+        // Accepts clients on a Unix domain socket at `path`, each served on its own thread, until the process ends.
+        [[noreturn]] void listen(const std::string& path) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof address.sun_path) throw std::runtime_error("Socket path too long: " + path);
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener < 0) throw std::runtime_error("Could not create a socket");
+            ::unlink(path.c_str());
+            if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof address) < 0 or
+                ::listen(listener, SOMAXCONN) < 0) {
+                ::close(listener);
+                throw std::runtime_error("Could not listen on " + path);
+            }
+            // A client hanging up before its answers are written must not kill the daemon.
+            std::signal(SIGPIPE, SIG_IGN);
+            while (true) {
+                const int client = ::accept(listener, nullptr, nullptr);
+                if (client < 0) {
+                    if (errno == EINTR or errno == ECONNABORTED) continue;
+                    ::close(listener);
+                    throw std::runtime_error("Could not accept on " + path);
+                }
+                std::thread([this, client] {
+                    try { serve(client, client); }
+                    catch (const std::exception&) {}
+                    ::close(client);
+                }).detach();
+            }
+        }
+    };
+}
+
+#endif //JOB_SHOP_SERVICE
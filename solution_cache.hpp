@@ -0,0 +1,85 @@
+#ifndef JOB_SHOP_SOLUTION_CACHE
+#define JOB_SHOP_SOLUTION_CACHE
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#else
+#include <random>
+#endif
+#include "dataset.hpp"
+#include "mapped_file.hpp"
+#include "schedule.hpp"
+
+namespace js {
+
+    // Directory of binary schedules named `<dataset fingerprint>-<key>.jsps`, where the key names the algorithm
+    // and every parameter that changes its result. Entries that are missing, unreadable or for another instance
+    // count as misses. Stores go through a temporary file and a rename, so concurrent writers never expose a
+    // partial entry.
+    class solution_cache {
+
+        std::filesystem::path directory;
+        inline static std::atomic<size_t> temporary_count = 0;
+
+        // Distinguishes this process's temporary files from those of concurrent batch processes.
+        static unsigned long long process_token() {
+#if __has_include(<unistd.h>)
+            return (unsigned long long) ::getpid();
+#else
+            static const unsigned long long token = std::random_device()();
+            return token;
+#endif
+        }
+
+        [[nodiscard]] std::filesystem::path entry(const dataset& data, std::string_view key) const {
+            char hash[17];
+            snprintf(hash, sizeof hash, "%016llx", (unsigned long long) data.fingerprint());
+            return directory / (std::string(hash) + '-' + std::string(key) + ".jsps");
+        }
+
+    public:
+
+        explicit solution_cache(std::filesystem::path directory) : directory(std::move(directory)) {
+            std::filesystem::create_directories(this->directory);
+        }
+
+        // Replaces `schedule` with the entry and reports whether there was a complete one; on a miss `schedule`
+        // is left as it was.
+        bool load(const dataset& data, std::string_view key, schedule& schedule) const {
+            const std::filesystem::path path = entry(data, key);
+            if (not std::filesystem::exists(path)) return false;
+            js::schedule loaded(data);
+            try {
+                loaded.read_binary(mapped_file(path.c_str()).bytes());
+            } catch (const std::exception&) {
+                return false;
+            }
+            if (not loaded.is_complete()) return false;
+            schedule.reset();
+            schedule.assign_starts(loaded.start_times());
+            return true;
+        }
+
+        // Schedules with operations left unplaced are not stored.
+        void store(const dataset& data, std::string_view key, const schedule& schedule) const {
+            if (not schedule.is_complete()) return;
+            const std::filesystem::path path = entry(data, key);
+            std::filesystem::path temporary = path;
+            temporary += ".tmp" + std::to_string(process_token()) + '.' + std::to_string(temporary_count++);
+            {
+                std::ofstream file(temporary, std::ios::binary);
+                schedule.write_binary(file);
+                if (not file) throw std::runtime_error("Could not write " + temporary.string());
+            }
+            std::filesystem::rename(temporary, path);
+        }
+    };
+}
+
+#endif //JOB_SHOP_SOLUTION_CACHE
@@ -0,0 +1,94 @@
+#ifndef JOB_SHOP_SOLVER
+#define JOB_SHOP_SOLVER
+
+#include <optional>
+#include <stdexcept>
+#include "algorithms.hpp"
+#include "branch_and_bound.hpp"
+#include "dataset.hpp"
+#include "genetic_algorithm.hpp"
+#include "grasp.hpp"
+#include "instrument.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+#include "tabu_search.hpp"
+
+namespace js {
+
+    enum class solver_method { dispatch, grasp, genetic, exact };
+
+    struct solver_options {
+        solver_method method = solver_method::dispatch;
+        // Constructive rule of `dispatch` and `grasp`; stachu when null.
+        const named_algorithm* algorithm = nullptr;
+        // Run after the dispatch rule or the GA, and after every GRASP construction; the exact search ignores it.
+        std::optional<tabu_options> improve;
+        grasp_options grasp;
+        genetic_options genetic;
+        branch_and_bound_options exact;
+        // Handed to every stage in place of the control of its own options.
+        search_control* control = nullptr;
+    };
+
+    // Statistics of the stages that ran; `makespan` is the one of the filled schedule.
+    struct solver_result {
+        size_t makespan = 0;
+        std::optional<grasp_result> grasp;
+        std::optional<genetic_result> genetic;
+        std::optional<branch_and_bound_result> exact;
+        std::optional<tabu_result> tabu;
+    };
+
+    // Fills the empty `result` over `data` with the chosen method. Everything stays in memory, so embedders can build
+    // `data` with `dataset::from_arrays` and read the answer from `result.start_times()`.
+    inline solver_result solve(const dataset& data, schedule& result, solver_options options) {
+        const named_algorithm* algorithm = options.algorithm ? options.algorithm : find_algorithm("stachu");
+        if (algorithm == nullptr) throw std::runtime_error("No default algorithm");
+        options.grasp.control = options.genetic.control = options.exact.control = options.control;
+        if (options.improve) options.improve->control = options.control;
+        solver_result summary;
+        std::optional<scoped_phase> timed(phase::construct);
+        switch (options.method) {
+            case solver_method::exact:
+                summary.exact = branch_and_bound().run(data, result, options.exact);
+                break;
+            case solver_method::genetic:
+                summary.genetic = genetic_algorithm().run(data, result, options.genetic);
+                break;
+            case solver_method::grasp:
+                options.grasp.improve = options.improve;
+                summary.grasp = js::grasp(data, result, *algorithm, options.grasp);
+                break;
+            case solver_method::dispatch:
+                algorithm->run(data, result);
+                if (options.control) options.control->report(result.makespan(), result.start_times());
+                break;
+        }
+        timed.emplace(phase::improve);
+        if (options.improve and (options.method == solver_method::dispatch or options.method == solver_method::genetic))
+            summary.tabu = tabu_search().run(data, result, *options.improve);
+        summary.makespan = result.makespan();
+        return summary;
+    }
+
+    // Flexible instances: `routed` is a copy of the instance that `result` is over. The dispatch rule, mwkr when
+    // none is given, routes every operation to a machine in place; the tabu stage then resequences that routing
+    // as a classic instance.
+    inline solver_result solve_flexible(dataset& routed, schedule& result, solver_options options) {
+        if (options.method != solver_method::dispatch)
+            throw std::runtime_error("Flexible instances are solved by a dispatch rule and the tabu search only");
+        const named_algorithm* algorithm = options.algorithm ? options.algorithm : find_algorithm("mwkr");
+        if (algorithm == nullptr) throw std::runtime_error("No default algorithm");
+        if (options.improve) options.improve->control = options.control;
+        solver_result summary;
+        std::optional<scoped_phase> timed(phase::construct);
+        algorithm->route(routed, result);
+        if (options.control) options.control->report(result.makespan(), result.start_times());
+        timed.emplace(phase::improve);
+        if (options.improve) summary.tabu = tabu_search().run(routed, result, *options.improve);
+        summary.makespan = result.makespan();
+        return summary;
+    }
+}
+
+#endif //JOB_SHOP_SOLVER
@@ -0,0 +1,208 @@
+#ifndef JOB_SHOP_TABU_SEARCH
+#define JOB_SHOP_TABU_SEARCH
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "dataset.hpp"
+#include "disjunctive_graph.hpp"
+#include "lower_bound.hpp"
+#include "schedule.hpp"
+#include "search_control.hpp"
+
+namespace js {
+
+    struct tabu_options {
+        size_t iterations = 10000;
+        std::chrono::milliseconds time_limit{0};
+        size_t tenure = 12;
+        // Shared budget and incumbent of the whole solve; every new best is reported to it.
+        search_control* control = nullptr;
+    };
+
+    struct tabu_result {
+        size_t initial_makespan = 0, makespan = 0, iterations = 0, evaluated_moves = 0;
+    };
+
+    // Tabu search over the disjunctive graph of a schedule. Moves reorder the ends of critical blocks: N5 swaps
+    // of the first or last two operations, and N6 moves of an operation to the front or back of its block.
+    // Candidates are ranked by an estimate that recomputes heads and tails on the reordered segment only. The search
+    // stops early once it reaches the instance's lower bound.
+    class tabu_search {
+
+        static constexpr int32_t none = disjunctive_graph::none;
+
+        struct move {
+            int32_t first = none, last = none;
+            bool forward = true; // `first` moves right after `last`; otherwise `last` moves right before `first`
+        };
+
+        disjunctive_graph graph;
+        std::vector<std::pair<int32_t, int32_t>> forbidden;
+        std::vector<int32_t> path, segment;
+        std::vector<size_t> segment_head, segment_tail;
+        std::vector<std::pair<size_t, size_t>> blocks;
+        size_t forbidden_next = 0;
+
+        void critical_path(size_t length) {
+            path.clear();
+            int32_t op = none;
+            for (int32_t candidate = 0; candidate < (int32_t) graph.size() and op == none; candidate++)
+                if (graph.end_of(candidate) == length and graph.tail[candidate] == 0) op = candidate;
+            while (op != none) {
+                path.push_back(op);
+                const int32_t machine = graph.machine_prev[op], job = graph.job_prev[op];
+                op = machine != none and graph.end_of(machine) == graph.head[op] ? machine
+                   : job != none and graph.end_of(job) == graph.head[op] ? job : none;
+            }
+            std::reverse(path.begin(), path.end());
+        }
+
+        void collect_moves(std::vector<move>& moves) {
+            moves.clear();
+            blocks.clear();
+            for (size_t i = 0; i < path.size();) {
+                size_t j = i;
+                while (j + 1 < path.size() and graph.machine_next[path[j]] == path[j + 1]) j++;
+                if (j > i) blocks.emplace_back(i, j);
+                i = j + 1;
+            }
+            for (size_t b = 0; b < blocks.size(); b++) {
+                const auto [begin, end] = blocks[b];
+                const bool first_block = b == 0, last_block = b + 1 == blocks.size(), single = blocks.size() == 1;
+                if (not first_block or single) moves.push_back({path[begin], path[begin + 1], true});
+                if (end - begin > 1 and (not last_block or single)) moves.push_back({path[end - 1], path[end], true});
+                const int32_t first = path[begin], last = path[end];
+                for (size_t k = begin + 1; k < end; k++) {
+                    const int32_t u = path[k];
+                    if (k > begin + 1 and graph.end_of(first) >= graph.end_of(graph.job_prev[u]))
+                        moves.push_back({first, u, false});
+                    if (k + 1 < end and graph.chain_of(last) >= graph.chain_of(graph.job_next[u]))
+                        moves.push_back({u, last, true});
+                }
+                if (end - begin > 1) {
+                    if (graph.chain_of(last) >= graph.chain_of(graph.job_next[first]))
+                        moves.push_back({first, last, true});
+                    if (graph.end_of(first) >= graph.end_of(graph.job_prev[last]))
+                        moves.push_back({first, last, false});
+                }
+            }
+        }
+
+        // Makespan estimate after the move: new heads forward and tails backward across the reordered segment,
+        // taking everything outside of it at its current value.
+        size_t estimate(const move& m) {
+            segment.clear();
+            for (int32_t op = m.first;; op = graph.machine_next[op]) {
+                segment.push_back(op);
+                if (op == m.last) break;
+            }
+            if (m.forward) std::rotate(segment.begin(), segment.begin() + 1, segment.end());
+            else std::rotate(segment.begin(), segment.end() - 1, segment.end());
+            const size_t k = segment.size();
+            segment_head.resize(k);
+            segment_tail.resize(k);
+            size_t previous = graph.end_of(graph.machine_prev[m.first]);
+            for (size_t i = 0; i < k; i++) {
+                segment_head[i] = std::max(previous, graph.end_of(graph.job_prev[segment[i]]));
+                previous = segment_head[i] + graph.duration[segment[i]];
+            }
+            size_t next = graph.chain_of(graph.machine_next[m.last]), result = 0;
+            for (size_t i = k; i-- > 0;) {
+                segment_tail[i] = std::max(next, graph.chain_of(graph.job_next[segment[i]]));
+                next = segment_tail[i] + graph.duration[segment[i]];
+                result = std::max(result, segment_head[i] + graph.duration[segment[i]] + segment_tail[i]);
+            }
+            return result;
+        }
+
+        [[nodiscard]] bool is_forbidden(int32_t before, int32_t after) const {
+            return std::find(forbidden.begin(), forbidden.end(), std::make_pair(before, after)) != forbidden.end();
+        }
+
+        // A move is tabu when any order it creates inside the segment is forbidden, which also catches a chain of
+        // moves that rotates a block back into a recent state.
+        [[nodiscard]] bool is_tabu(const move& m) const {
+            if (m.forward) {
+                for (int32_t op = graph.machine_next[m.first];; op = graph.machine_next[op]) {
+                    if (is_forbidden(op, m.first)) return true;
+                    if (op == m.last) return false;
+                }
+            }
+            for (int32_t op = m.first; op != m.last; op = graph.machine_next[op])
+                if (is_forbidden(m.last, op)) return true;
+            return false;
+        }
+
+        void forbid(int32_t before, int32_t after) {
+            if (forbidden.empty()) return;
+            forbidden[forbidden_next] = {before, after};
+            forbidden_next = (forbidden_next + 1) % forbidden.size();
+        }
+
+    public:
+
+        tabu_result run(const dataset& data, schedule& schedule, const tabu_options& options) {
+            const auto started = std::chrono::steady_clock::now();
+            graph = disjunctive_graph::from_schedule(data, schedule);
+            forbidden.assign(options.tenure, {none, none});
+            forbidden_next = 0;
+
+            tabu_result result;
+            result.initial_makespan = schedule.makespan();
+            result.makespan = graph.makespan();
+            disjunctive_graph best = graph;
+            const size_t bound = compute_lower_bounds(data).value();
+            std::vector<move> moves;
+            size_t current = result.makespan;
+            for (; result.iterations < options.iterations and result.makespan > bound; result.iterations++) {
+                if (options.time_limit.count() > 0 and (result.iterations & 63) == 0 and
+                    std::chrono::steady_clock::now() - started >= options.time_limit)
+                    break;
+                if (options.control and options.control->poll(result.iterations)) break;
+                critical_path(current);
+                collect_moves(moves);
+                if (moves.empty()) break;
+                const move* chosen = nullptr;
+                size_t chosen_estimate = -1;
+                bool chosen_forbidden = true;
+                for (const move& m : moves) {
+                    const size_t value = estimate(m);
+                    result.evaluated_moves++;
+                    const bool tabu = value >= result.makespan and is_tabu(m);
+                    if (chosen == nullptr or (chosen_forbidden and not tabu) or
+                        (tabu == chosen_forbidden and value < chosen_estimate))
+                        chosen = &m, chosen_estimate = value, chosen_forbidden = tabu;
+                }
+                // Both kinds of move put `last` before `first`; putting them back becomes tabu.
+                const move m = *chosen;
+                const int32_t moved = m.forward ? m.first : m.last;
+                const int32_t previous = graph.machine_prev[moved], next = graph.machine_next[moved];
+                graph.unlink(moved);
+                if (m.forward) graph.link_after(moved, m.last);
+                else graph.link_before(moved, m.first);
+                if (not graph.evaluate()) {
+                    graph.unlink(moved);
+                    if (previous != none) graph.link_after(moved, previous);
+                    else graph.link_before(moved, next);
+                    graph.evaluate();
+                    forbid(m.last, m.first);
+                    continue;
+                }
+                forbid(m.first, m.last);
+                current = graph.makespan();
+                if (current < result.makespan) {
+                    result.makespan = current;
+                    best = graph;
+                    if (options.control) options.control->report(current, graph.head);
+                }
+            }
+
+            if (result.makespan < result.initial_makespan) best.to_schedule(schedule);
+            return result;
+        }
+    };
+}
+
+#endif //JOB_SHOP_TABU_SEARCH
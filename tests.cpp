@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <cstdlib>
+#include "algorithms.hpp"
+#include "dataset.hpp"
+#include "schedule.hpp"
+
+// Regression checks for inputs the solvers once rejected or mishandled; exits non-zero on the first failure.
+
+static void check(bool condition, const char* what) {
+    if (condition) return;
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    std::exit(1);
+}
+
+// Durations beyond 16 bits, which a narrow flat layout cannot hold.
+static void stachu_long_durations() {
+    const js::dataset data = js::dataset::parse("2 2\n0 70000 1 5\n1 3 0 2\n");
+    js::schedule schedule(data);
+    js::find_algorithm("stachu")->run(data, schedule);
+    check(schedule.is_complete(), "stachu places every operation of a long instance");
+    check(schedule.makespan() == 70005, "stachu keeps durations above 65535");
+}
+
+// Jobs with fewer operations than machines, as routed flexible instances have.
+static void stachu_non_rectangular() {
+    js::dataset data = js::dataset::parse("3 2\n0 4 1 2\n1 3 0 1\n0 5 1 1\n");
+    data.tasks[2].sequence.pop_back();
+    js::schedule schedule(data);
+    js::find_algorithm("stachu")->run(data, schedule);
+    check(schedule.is_complete(), "stachu places every operation of a non-rectangular instance");
+    check(schedule.makespan() == 11, "stachu orders rounds without the missing operation");
+}
+
+// A move may not land in a window where the machine is down.
+static void move_respects_downtime() {
+    const js::dataset data = js::dataset::parse("1 1\n0 5\n");
+    js::schedule schedule(data);
+    const js::sub_task& operation = data.tasks[0].sequence[0];
+    schedule.add_sub_task(operation);
+    schedule.block(0, 10, 20);
+    check(not schedule.move_sub_task(operation, 12), "a move into downtime is refused");
+    check(schedule.start(operation) == 0, "a refused move keeps the operation in place");
+    check(not schedule.move_sub_task(operation, 8), "a move overlapping the start of downtime is refused");
+    check(schedule.move_sub_task(operation, 20) and schedule.start(operation) == 20, "a move after downtime succeeds");
+}
+
+int main() {
+    stachu_long_durations();
+    stachu_non_rectangular();
+    move_respects_downtime();
+    std::puts("all tests passed");
+}
@@ -0,0 +1,71 @@
+#ifndef JOB_SHOP_TEXT_READER
+#define JOB_SHOP_TEXT_READER
+
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace js {
+
+    // Whitespace-separated integer reader over a single in-memory buffer.
+    class text_reader {
+
+        std::string_view text;
+        std::string source;
+        size_t position = 0, token = 0;
+
+        void skip_whitespace() {
+            while (position < text.size() and
+                   (text[position] == ' ' or text[position] == '\t' or text[position] == '\r' or text[position] == '\n'))
+                position++;
+        }
+
+    public:
+
+        text_reader(std::string_view text, std::string source) : text(text), source(std::move(source)) {}
+
+        static std::string read_file(const char* path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (not file.is_open()) throw std::runtime_error("Could not open file " + std::string(path));
+            std::string buffer((size_t) file.tellg(), '\0');
+            file.seekg(0);
+            file.read(buffer.data(), (std::streamsize) buffer.size());
+            return buffer;
+        }
+
+        // Reports the start of the last token read; line and column are only computed here, off the fast path.
+        [[noreturn]] void fail(const std::string& message) const {
+            size_t line = 1, column = 1;
+            for (size_t i = 0; i < token; i++) {
+                if (text[i] == '\n') line++, column = 1;
+                else column++;
+            }
+            throw std::runtime_error(source + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
+        }
+
+        // Skips the rest of the current line, for trailing fields a format ignores.
+        void skip_line() {
+            while (position < text.size() and text[position] != '\n') position++;
+        }
+
+        template<typename T>
+        T read(const char* what) {
+            skip_whitespace();
+            token = position;
+            if (position == text.size()) fail(std::string("unexpected end of input, expected ") + what);
+            T value;
+            const char* first = text.data() + position;
+            const auto [last, error] = std::from_chars(first, text.data() + text.size(), value);
+            if (error == std::errc::result_out_of_range) fail(std::string(what) + " out of range");
+            if (error != std::errc() or (last != text.data() + text.size() and *last != ' ' and *last != '\t' and
+                                         *last != '\r' and *last != '\n'))
+                fail(std::string("expected ") + what);
+            position = last - text.data();
+            return value;
+        }
+    };
+}
+
+#endif //JOB_SHOP_TEXT_READER
@@ -0,0 +1,183 @@
+#ifndef JOB_SHOP_THREAD_POOL
+#define JOB_SHOP_THREAD_POOL
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace js {
+
+    // Fixed set of workers, each with its own deque. Workers pop their own newest task and steal the oldest one
+    // from the others when idle; tasks submitted from inside a worker go to that worker's deque. Pinned workers
+    // are bound, before running anything, to the CPUs the process may use in order, so consecutive workers fill
+    // a socket before the next one and memory first touched by a worker stays on its node (Linux only). A pool of
+    // one thread starts none and runs every task on the submitting thread, so single-threaded searches, as the
+    // solver service runs them, pay no thread creation.
+    class thread_pool {
+
+        struct worker_queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<worker_queue>> queues;
+        std::vector<std::thread> threads;
+        std::mutex state_mutex;
+        std::condition_variable wake, idle;
+        std::atomic<size_t> queued = 0, next_queue = 0;
+        size_t pending = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+        std::vector<int> cpus;
+
+        inline static thread_local const thread_pool* owner = nullptr;
+        inline static thread_local size_t owner_index = 0;
+
+        bool take(size_t index, std::function<void()>& task) {
+            for (size_t k = 0; k < queues.size(); k++) {
+                worker_queue& queue = *queues[(index + k) % queues.size()];
+                std::lock_guard lock(queue.mutex);
+                if (queue.tasks.empty()) continue;
+                if (k == 0) task = std::move(queue.tasks.back()), queue.tasks.pop_back();
+                else task = std::move(queue.tasks.front()), queue.tasks.pop_front();
+                queued--;
+                return true;
+            }
+            return false;
+        }
+
+        static std::vector<int> allowed_cpus() {
+            std::vector<int> result;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof set, &set) == 0)
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                    if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+#endif
+            return result;
+        }
+
+        void pin(size_t index) const {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[index % cpus.size()], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+#else
+            (void) index;
+#endif
+        }
+
+        void work(size_t index) {
+            owner = this;
+            owner_index = index;
+            if (not cpus.empty()) pin(index);
+            while (true) {
+                std::function<void()> task;
+                if (take(index, task)) {
+                    try { task(); }
+                    catch (...) {
+                        std::lock_guard lock(state_mutex);
+                        if (not failure) failure = std::current_exception();
+                    }
+                    std::lock_guard lock(state_mutex);
+                    if (--pending == 0) idle.notify_all();
+                    continue;
+                }
+                std::unique_lock lock(state_mutex);
+                wake.wait(lock, [&] { return stopping or queued > 0; });
+                if (stopping and queued == 0) return;
+            }
+        }
+
+    public:
+
+        explicit thread_pool(size_t thread_count = std::thread::hardware_concurrency(), bool pinned = false) {
+            thread_count = std::max<size_t>(thread_count, 1);
+            if (pinned) cpus = allowed_cpus();
+            for (size_t i = 0; i < thread_count; i++) queues.push_back(std::make_unique<worker_queue>());
+            if (thread_count == 1) return;
+            for (size_t i = 0; i < thread_count; i++) threads.emplace_back([this, i] { work(i); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock(state_mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& thread : threads) thread.join();
+        }
+
+        [[nodiscard]] size_t size() const { return queues.size(); }
+
+        // Index of the calling worker in [0, size()); only meaningful inside a task running on this pool.
+        [[nodiscard]] size_t worker_index() const { return owner == this ? owner_index : 0; }
+
+        void submit(std::function<void()> task) {
+            if (threads.empty()) {
+                try { task(); }
+                catch (...) { if (not failure) failure = std::current_exception(); }
+                return;
+            }
+            const size_t index = owner == this ? owner_index : next_queue++ % queues.size();
+            {
+                // Counted together with the push, so a worker taking and finishing the task at once can neither
+                // drive the counts below zero nor let wait() return while its parent task is still running.
+                std::lock_guard state(state_mutex);
+                std::lock_guard lock(queues[index]->mutex);
+                queues[index]->tasks.push_back(std::move(task));
+                queued++;
+                pending++;
+            }
+            wake.notify_one();
+        }
+
+        // Blocks until every submitted task has finished; rethrows the first exception a task threw.
+        void wait() {
+            std::unique_lock lock(state_mutex);
+            idle.wait(lock, [&] { return pending == 0; });
+            if (failure) std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+    };
+
+    // One T per worker of a pool, built by that worker on first use, so its memory is first touched on the node
+    // the worker runs on instead of by the thread that created the pool.
+    template<typename T>
+    class worker_local {
+
+        const thread_pool& pool;
+        std::vector<std::unique_ptr<T>> slots;
+
+    public:
+
+        explicit worker_local(const thread_pool& pool) : pool(pool), slots(pool.size()) {}
+
+        // Only from a task running on the pool; `arguments` are used when this worker has no T yet.
+        template<typename... Arguments>
+        T& get(const Arguments&... arguments) {
+            std::unique_ptr<T>& slot = slots[pool.worker_index()];
+            if (not slot) slot = std::make_unique<T>(arguments...);
+            return *slot;
+        }
+    };
+}
+
+#endif //JOB_SHOP_THREAD_POOL
@@ -0,0 +1,126 @@
+#ifndef JOB_SHOP_TIMELINE
+#define JOB_SHOP_TIMELINE
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "gap_tree.hpp"
+#include "instrument.hpp"
+#include "occupancy.hpp"
+
+namespace js {
+
+    struct interval {
+        size_t start = 0, end = 0;
+        int16_t task_id = -1, position = -1;
+    };
+
+    // Optional index answering is_free and next_fit in place of the interval scan.
+    enum class placement_index { none, bitset, gaps };
+
+    // Busy intervals of a single machine or job, kept sorted and disjoint.
+    class timeline {
+
+        std::vector<interval> intervals;
+        std::vector<size_t> instants;
+        std::optional<occupancy> bits;
+        std::optional<gap_tree> gaps;
+        size_t length = 0;
+
+    public:
+
+        using const_iterator = std::vector<interval>::const_iterator;
+
+        // First interval that ends after `time`, i.e. the first one that can overlap [time, ...).
+        [[nodiscard]] const_iterator first_ending_after(size_t time) const {
+            return std::upper_bound(intervals.begin(), intervals.end(), time,
+                                    [](size_t t, const interval& i) { return t < i.end; });
+        }
+
+        // Mirrors the intervals in a bitset that then answers is_free and next_fit a word at a time; worth it
+        // when horizons are short and machines densely packed.
+        void index_occupancy() {
+            bits.emplace();
+            for (const interval& busy : intervals) bits->insert(busy.start, busy.end);
+        }
+
+        // Keeps the idle gaps in a tree searched in O(log gaps), for long timelines with many gaps to jump over.
+        void index_gaps() {
+            gaps.emplace();
+            for (const interval& busy : intervals) gaps->occupy(busy.start, busy.end);
+        }
+
+        void index(placement_index kind) {
+            if (kind == placement_index::bitset) index_occupancy();
+            else if (kind == placement_index::gaps) index_gaps();
+        }
+
+        [[nodiscard]] bool is_free(size_t start, size_t end) const {
+            if (bits) return bits->is_free(start, end);
+            if (gaps) return gaps->is_free(start, end);
+            if (start >= end) return true;
+            const auto it = first_ending_after(start);
+            return it == intervals.end() or it->start >= end;
+        }
+
+        // Earliest t >= start with [t, t + duration) free, jumping over conflicting intervals.
+        [[nodiscard]] size_t next_fit(size_t start, size_t duration) const {
+            if (duration == 0) return start;
+            if (bits) return bits->next_fit(start, duration);
+            if (gaps) return gaps->next_fit(start, duration);
+            for (auto it = first_ending_after(start); it != intervals.end() and it->start < start + duration; ++it) {
+                start = it->end;
+                instrumentation::count(counter::intervals_skipped);
+            }
+            return start;
+        }
+
+        // Interval starting exactly at `start`, or end() when there is none.
+        [[nodiscard]] const_iterator find(size_t start) const {
+            const auto it = std::lower_bound(intervals.begin(), intervals.end(), start,
+                                             [](const interval& i, size_t t) { return i.start < t; });
+            return it != intervals.end() and it->start == start ? it : intervals.end();
+        }
+
+        void insert(const interval& busy) {
+            length = std::max(length, busy.end);
+            if (busy.start >= busy.end) instants.push_back(busy.start);
+            else intervals.insert(first_ending_after(busy.start), busy);
+            if (bits) bits->insert(busy.start, busy.end);
+            if (gaps) gaps->occupy(busy.start, busy.end);
+        }
+
+        void erase(const interval& busy) {
+            if (busy.start >= busy.end) {
+                const auto it = std::find(instants.begin(), instants.end(), busy.start);
+                if (it != instants.end()) instants.erase(it);
+            } else if (const auto it = find(busy.start); it != intervals.end()) intervals.erase(it);
+            if (bits) bits->erase(busy.start, busy.end);
+            if (gaps) gaps->release(busy.start, busy.end);
+            if (busy.end < length) return;
+            length = intervals.empty() ? 0 : intervals.back().end;
+            for (size_t t : instants) length = std::max(length, t);
+        }
+
+        // Drops every interval but keeps the storage, so a timeline can be refilled without allocating.
+        void clear() {
+            intervals.clear();
+            instants.clear();
+            if (bits) bits->clear();
+            if (gaps) gaps->clear();
+            length = 0;
+        }
+
+        // Time unit after the last one touched, zero-length intervals included.
+        [[nodiscard]] size_t horizon() const { return length; }
+
+        [[nodiscard]] size_t size() const { return intervals.size(); }
+
+        [[nodiscard]] const_iterator begin() const { return intervals.begin(); }
+
+        [[nodiscard]] const_iterator end() const { return intervals.end(); }
+    };
+}
+
+#endif //JOB_SHOP_TIMELINE